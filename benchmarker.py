@@ -1,6 +1,9 @@
 import subprocess
 import statistics
 import argparse
+import json
+import os
+import tempfile
 
 def run_benchmark(command, num_runs):
     """
@@ -14,15 +17,17 @@ def run_benchmark(command, num_runs):
         tuple: (mean time, standard deviation of times)
     """
     times = []
-    
-    for _ in range(num_runs):
-        # Run the command and capture output
-        result = subprocess.run(command, capture_output=True, text=True)
-        
-        # Parse the final CPU time from the last line
-        last_line = result.stdout.strip().split('\n')[-1]
-        time_str = last_line.split(':')[-1].strip().split()[0]
-        times.append(float(time_str))
+    fd, report = tempfile.mkstemp(suffix='.json')
+    os.close(fd)
+    
+    try:
+        for _ in range(num_runs):
+            # Run the command quietly and read the final CPU time from its JSON report
+            subprocess.run(command + ['-quiet', '-report', report], capture_output=True, text=True, check=True)
+            with open(report) as f:
+                times.append(float(json.load(f)['cpu_sec']))
+    finally:
+        os.remove(report)
     
     # Calculate statistics
     mean_time = statistics.mean(times)
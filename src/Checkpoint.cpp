@@ -0,0 +1,244 @@
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include "Profiler.h"
+#include "SimpleGR.h"
+
+///////////////////////////////////////////////////////////////////////////////
+// Checkpoint file, in native byte order:
+//   magic "SGRCKPT\0", version
+//   sizeX, sizeY, layers, edges, nets, iteration, rrrDone, rrrCpuSec
+//   per edge: capacity, usage (bytes), then history costs
+//   per net: routed (bytes), then routeBegin (nets + 1) and routeEdges
+//   FNV-1a hash of everything before it
+///////////////////////////////////////////////////////////////////////////////
+
+static const char checkpointMagic[8] = { 'S', 'G', 'R', 'C', 'K', 'P', 'T', '\0' };
+static constexpr uint32_t checkpointVersion = 1;
+
+namespace {
+
+class ByteWriter
+{
+  public:
+    std::string bytes;
+
+    template<typename T> void put(const T &value)
+    {
+        bytes.append(reinterpret_cast<const char *>(&value), sizeof(T));
+    }
+    template<typename T> void put(const std::vector<T> &values)
+    {
+        bytes.append(reinterpret_cast<const char *>(values.data()), values.size() * sizeof(T));
+    }
+};
+
+// reads from a buffer, failing instead of reading past its end
+class ByteReader
+{
+  public:
+    ByteReader(const std::string &bytes, std::size_t end) : bytes_(bytes), end_(end) {}
+
+    template<typename T> bool get(T &value)
+    {
+        if (end_ - pos_ < sizeof(T)) { return false; }
+        std::memcpy(&value, bytes_.data() + pos_, sizeof(T));
+        pos_ += sizeof(T);
+        return true;
+    }
+    template<typename T> bool get(std::vector<T> &values, std::size_t count)
+    {
+        if ((end_ - pos_) / sizeof(T) < count) { return false; }
+        values.resize(count);
+        std::memcpy(values.data(), bytes_.data() + pos_, count * sizeof(T));
+        pos_ += count * sizeof(T);
+        return true;
+    }
+    bool atEnd(void) const { return pos_ == end_; }
+
+  private:
+    const std::string &bytes_;
+    const std::size_t end_;
+    std::size_t pos_{ 0 };
+};
+
+}// namespace
+
+bool Checkpoint::write(const std::string &filename) const
+{
+    ByteWriter out;
+    out.put(checkpointMagic);
+    out.put(checkpointVersion);
+    out.put(sizeX);
+    out.put(sizeY);
+    out.put(layers);
+    out.put(static_cast<uint32_t>(capacity.size()));
+    out.put(static_cast<uint32_t>(routed.size()));
+    out.put(static_cast<uint32_t>(iteration));
+    out.put(static_cast<uint8_t>(rrrDone ? 1 : 0));
+    out.put(rrrCpuSec);
+    out.put(capacity);
+    out.put(usage);
+    out.put(history);
+    out.put(routed);
+    out.put(routeBegin);
+    out.put(routeEdges);
+    out.put(fnv1a(out.bytes.data(), out.bytes.size()));
+
+    // a crash while writing leaves the previous checkpoint in place
+    const std::string tmpname = filename + ".tmp";
+    {
+        std::ofstream outfile(tmpname.c_str(), std::ios::binary | std::ios::trunc);
+        outfile.write(out.bytes.data(), static_cast<std::streamsize>(out.bytes.size()));
+        if (!outfile.good()) { return false; }
+    }
+    return std::rename(tmpname.c_str(), filename.c_str()) == 0;
+}
+
+bool Checkpoint::read(const std::string &filename)
+{
+    std::ifstream infile(filename.c_str(), std::ios::binary | std::ios::ate);
+    if (!infile.good()) { return false; }
+    std::string bytes(static_cast<std::size_t>(std::max<std::streamoff>(0, infile.tellg())), '\0');
+    infile.seekg(0);
+    infile.read(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    if (!infile.good()) { return false; }
+
+    uint64_t hash = 0;
+    if (bytes.size() < sizeof(hash)) { return false; }
+    const std::size_t end = bytes.size() - sizeof(hash);
+    std::memcpy(&hash, bytes.data() + end, sizeof(hash));
+    if (hash != fnv1a(bytes.data(), end)) { return false; }
+
+    ByteReader in(bytes, end);
+    char magic[sizeof(checkpointMagic)];
+    uint32_t version = 0, edges = 0, nets = 0, iter = 0;
+    uint8_t done = 0;
+    if (!in.get(magic) || std::memcmp(magic, checkpointMagic, sizeof(magic)) != 0 || !in.get(version)
+        || version != checkpointVersion) {
+        return false;
+    }
+    if (!in.get(sizeX) || !in.get(sizeY) || !in.get(layers) || !in.get(edges) || !in.get(nets) || !in.get(iter)
+        || !in.get(done) || !in.get(rrrCpuSec)) {
+        return false;
+    }
+    iteration = iter;
+    rrrDone = done != 0;
+    if (!in.get(capacity, edges) || !in.get(usage, edges) || !in.get(history, edges) || !in.get(routed, nets)
+        || !in.get(routeBegin, static_cast<std::size_t>(nets) + 1) || routeBegin.front() != 0
+        || !in.get(routeEdges, routeBegin.back())) {
+        return false;
+    }
+    for (uint32_t i = 0; i < nets; ++i) {
+        if (routeBegin[i] > routeBegin[i + 1]) { return false; }
+    }
+    return in.atEnd();
+}
+
+void CheckpointWriter::write(Checkpoint &&checkpoint, const std::string &filename)
+{
+    wait();
+    done_.store(false, std::memory_order_relaxed);
+    thread_ = std::thread([this, filename](Checkpoint cp) {
+        if (!cp.write(filename)) { std::cout << "Could not write checkpoint `" << filename << "'" << std::endl; }
+        done_.store(true, std::memory_order_release);
+    },
+        std::move(checkpoint));
+}
+
+//@brief: snapshot the routing state and hand it to the background writer. The copy is
+//        cheap next to an RRR iteration; serializing and writing happen off the router.
+void SimpleGR::saveCheckpoint(unsigned iteration, bool rrrDone, double rrrCpuSec)
+{
+    if (params.checkpointFile.empty()) { return; }
+    if (!rrrDone && checkpointWriter.busy()) { return; }
+
+    GR_PROFILE_SCOPE("saveCheckpoint");
+
+    Checkpoint cp;
+    cp.sizeX = gcellArrSzX;
+    cp.sizeY = gcellArrSzY;
+    cp.layers = numLayers;
+    cp.iteration = iteration;
+    cp.rrrDone = rrrDone;
+    cp.rrrCpuSec = rrrCpuSec;
+    cp.capacity.reserve(grEdgeArr.size());
+    cp.usage.reserve(grEdgeArr.size());
+    cp.history.reserve(grEdgeArr.size());
+    for (const Edge &edge : grEdgeArr) {
+        cp.capacity.push_back(static_cast<uint8_t>(edge.capacity));
+        cp.usage.push_back(static_cast<uint8_t>(edge.usage));
+        cp.history.push_back(edge.historyCost);
+    }
+    cp.routed.reserve(grNetArr.size());
+    cp.routeBegin.reserve(grNetArr.size() + 1);
+    cp.routeEdges.reserve(totalSegments + totalVias);
+    cp.routeBegin.push_back(0);
+    for (const Net &net : grNetArr) {
+        cp.routed.push_back(net.routed ? 1 : 0);
+        cp.routeEdges.insert(cp.routeEdges.end(), net.segments.begin(), net.segments.end());
+        cp.routeBegin.push_back(static_cast<IdType>(cp.routeEdges.size()));
+    }
+
+    checkpointWriter.write(std::move(cp), params.checkpointFile);
+}
+
+//@brief: restore the routes and history costs of -resume in place of initial routing;
+//        false, with the design left as it was, if the checkpoint cannot be read or is
+//        not of this design (the reason in parseError())
+bool SimpleGR::loadCheckpoint(void)
+{
+    using namespace std;
+
+    Checkpoint &cp = resumed;
+    const string name = "checkpoint `" + params.resumeFile + "'";
+    if (!cp.read(params.resumeFile)) { return parseFailed("could not read " + name); }
+    if (cp.sizeX != gcellArrSzX || cp.sizeY != gcellArrSzY || cp.layers != numLayers
+        || cp.capacity.size() != grEdgeArr.size() || cp.routed.size() != grNetArr.size()) {
+        return parseFailed(name + " is of a different design");
+    }
+    for (IdType i = 0; i < grEdgeArr.size(); ++i) {
+        if (cp.capacity[i] != grEdgeArr[i].capacity) { return parseFailed(name + " is of a different design"); }
+    }
+
+    // the routes must add up to the usage recorded with them before any is restored
+    vector<CapType> usage(grEdgeArr.size());
+    for (IdType i = 0; i < grEdgeArr.size(); ++i) { usage[i] = grEdgeArr[i].usage; }
+    vector<IdType> route;
+    for (IdType i = 0; i < grNetArr.size(); ++i) {
+        route.assign(cp.routeEdges.begin() + cp.routeBegin[i], cp.routeEdges.begin() + cp.routeBegin[i + 1]);
+        sort(route.begin(), route.end());
+        if (adjacent_find(route.begin(), route.end()) != route.end()
+            || (!route.empty() && route.back() >= grEdgeArr.size())) {
+            return parseFailed(name + " has an illegal edge");
+        }
+        for (const IdType e : route) {
+            const Edge &edge = grEdgeArr[e];
+            usage[e] += edge.type == VIA ? 0 : minWidths[edge.layer] + minSpacings[edge.layer];
+        }
+    }
+    for (IdType i = 0; i < grEdgeArr.size(); ++i) {
+        if (cp.usage[i] != static_cast<uint8_t>(usage[i])) {
+            return parseFailed(name + " routes do not match its edge usage");
+        }
+    }
+
+    for (IdType i = 0; i < grEdgeArr.size(); ++i) { grEdgeArr[i].historyCost = cp.history[i]; }
+    for (IdType i = 0; i < grNetArr.size(); ++i) {
+        Net &net = grNetArr[i];
+        for (IdType k = cp.routeBegin[i]; k < cp.routeBegin[i + 1]; ++k) { addSegment(net, grEdgeArr[cp.routeEdges[k]]); }
+        net.routed = cp.routed[i] != 0;
+    }
+
+    // only the progress is kept
+    cp.capacity = vector<uint8_t>();
+    cp.usage = vector<uint8_t>();
+    cp.history = vector<CostType>();
+    cp.routed = vector<uint8_t>();
+    cp.routeBegin = vector<IdType>();
+    cp.routeEdges = vector<IdType>();
+    return true;
+}
@@ -0,0 +1,371 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#ifdef GR_HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+#include "Profiler.h"
+#include "SimpleGR.h"
+
+// XPM colors, from white (empty) through blue and green to dark red (the worst ratio);
+// the first character of each is its pixel character
+static const char *const coolMap[] = {
+    /* columns rows colors chars-per-pixel */
+    "a c #ffffff",
+    "b c #00009f",
+    "c c #0000af",
+    "d c #0000bf",
+    "e c #0000cf",
+    "f c #0000df",
+    "g c #0000ef",
+    "h c #0000ff",
+    "i c #000fff",
+    "j c #001fff",
+    "k c #002fff",
+    "l c #003fff",
+    "m c #004fff",
+    "n c #005fff",
+    "o c #006fff",
+    "p c #007fff",
+    "q c #008fff",
+    "r c #009fff",
+    "s c #00afff",
+    "t c #00bfff",
+    "u c #00cfff",
+    "v c #00dfff",
+    "w c #00efff",
+    "x c #00ffff",
+    "y c #0fffef",
+    "z c #1fffdf",
+    "A c #2fffcf",
+    "B c #3fffbf",
+    "C c #4fffaf",
+    "D c #5fff9f",
+    "E c #6fff8f",
+    "F c #7fff7f",
+    "G c #8fff6f",
+    "H c #9fff5f",
+    "I c #afff4f",
+    "J c #bfff3f",
+    "K c #cfff2f",
+    "L c #dfff1f",
+    "M c #efff0f",
+    "N c #ffff00",
+    "O c #ffef00",
+    "P c #ffdf00",
+    "Q c #ffcf00",
+    "R c #ffbf00",
+    "S c #ffaf00",
+    "T c #ff9f00",
+    "U c #ff8f00",
+    "V c #ff7f00",
+    "W c #ff6f00",
+    "X c #ff5f00",
+    "Y c #ff4f00",
+    "Z c #ff3f00",
+    "0 c #ff2f00",
+    "1 c #ff1f00",
+    "2 c #ff0f00",
+    "3 c #ff0000",
+    "4 c #ef0000",
+    "5 c #df0000",
+    "6 c #cf0000",
+    "7 c #bf0000",
+    "8 c #af0000",
+    "9 c #9f0000",
+    ", c #8f0000",
+    ". c #7f0000"
+};
+
+static const unsigned numColors = 64;
+
+static unsigned colorIndex(double ratio, double maxRatio)
+{
+    const double scaled = std::floor(ratio / maxRatio * static_cast<double>(numColors - 1));
+    return scaled > 0. ? std::min(numColors - 1, static_cast<unsigned>(scaled)) : 0;
+}
+
+static void colorRGB(unsigned index, unsigned char rgb[3])
+{
+    const unsigned long hex = std::strtoul(coolMap[index] + 5, nullptr, 16);
+    rgb[0] = static_cast<unsigned char>(hex >> 16);
+    rgb[1] = static_cast<unsigned char>(hex >> 8);
+    rgb[2] = static_cast<unsigned char>(hex);
+}
+
+static void putBigEndian(std::string &out, uint32_t value)
+{
+    for (int shift = 24; shift >= 0; shift -= 8) { out.push_back(static_cast<char>(value >> shift)); }
+}
+
+static uint32_t crc32(const char *data, std::size_t size)
+{
+    static const std::vector<uint32_t> table = []() {
+        std::vector<uint32_t> t(256);
+        for (uint32_t n = 0; n < 256; ++n) {
+            uint32_t c = n;
+            for (int k = 0; k < 8; ++k) { c = (c & 1) ? 0xedb88320U ^ (c >> 1) : c >> 1; }
+            t[n] = c;
+        }
+        return t;
+    }();
+    uint32_t crc = 0xffffffffU;
+    for (std::size_t i = 0; i < size; ++i) { crc = table[(crc ^ static_cast<unsigned char>(data[i])) & 0xff] ^ (crc >> 8); }
+    return crc ^ 0xffffffffU;
+}
+
+static void pngChunk(std::string &out, const char *type, const std::string &data)
+{
+    putBigEndian(out, static_cast<uint32_t>(data.size()));
+    const std::size_t begin = out.size();
+    out.append(type, 4);
+    out.append(data);
+    putBigEndian(out, crc32(out.data() + begin, out.size() - begin));
+}
+
+//@brief: zlib stream of `raw`, compressed with zlib where the build found it and in
+//        stored (uncompressed) deflate blocks otherwise
+static std::string zlibStream(const std::string &raw)
+{
+#ifdef GR_HAVE_ZLIB
+    uLongf compressedSize = compressBound(raw.size());
+    std::string compressed(compressedSize, '\0');
+    if (compress2(reinterpret_cast<Bytef *>(&compressed[0]), &compressedSize,
+            reinterpret_cast<const Bytef *>(raw.data()), raw.size(), Z_BEST_SPEED)
+        == Z_OK) {
+        compressed.resize(compressedSize);
+        return compressed;
+    }
+#endif
+    std::string out("\x78\x01", 2);
+    std::size_t pos = 0;
+    do {
+        const std::size_t size = std::min<std::size_t>(raw.size() - pos, 65535);
+        out.push_back(pos + size == raw.size() ? 1 : 0);
+        out.push_back(static_cast<char>(size & 0xff));
+        out.push_back(static_cast<char>(size >> 8));
+        out.push_back(static_cast<char>(~size & 0xff));
+        out.push_back(static_cast<char>((~size >> 8) & 0xff));
+        out.append(raw, pos, size);
+        pos += size;
+    } while (pos < raw.size());
+
+    uint32_t a = 1, b = 0;
+    for (const char c : raw) {
+        a = (a + static_cast<unsigned char>(c)) % 65521;
+        b = (b + a) % 65521;
+    }
+    putBigEndian(out, b << 16 | a);
+    return out;
+}
+
+double CongestionMap::maxRatio(void) const
+{
+    double result = 1.;
+    for (const double ratio : ratios) { result = std::max(result, ratio); }
+    return result;
+}
+
+bool CongestionMap::parseFormat(const std::string &name, Format &format)
+{
+    if (name == "xpm") {
+        format = XPM;
+    } else if (name == "ppm") {
+        format = PPM;
+    } else if (name == "png") {
+        format = PNG;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+const char *CongestionMap::extension(Format format)
+{
+    switch (format) {
+    case PPM:
+        return ".ppm";
+    case PNG:
+        return ".png";
+    default:
+        return ".xpm";
+    }
+}
+
+bool CongestionMap::write(const std::string &basename, Format format) const
+{
+    GR_PROFILE_SCOPE("writeCongestionMap");
+
+    const double maxR = scale > 0. ? scale : maxRatio();
+    std::string out;
+
+    if (format == XPM) {
+        out += "/* XPM */\nstatic char *congestion[] = {\n/* columns rows colors chars-per-pixel */\n";
+        out += "\"" + std::to_string(width) + " " + std::to_string(height) + " " + std::to_string(numColors) + " 1\",\n";
+        for (unsigned i = 0; i < numColors; ++i) { out += "\"" + std::string(coolMap[i]) + "\",\n"; }
+        out += "/* pixels */\n";
+        out.reserve(out.size() + static_cast<std::size_t>(height) * (width + 4));
+        for (unsigned j = 0; j < height; ++j) {
+            out.push_back('"');
+            for (unsigned i = 0; i < width; ++i) { out.push_back(coolMap[colorIndex(ratios[j * width + i], maxR)][0]); }
+            out += j + 1 == height ? "\"\n" : "\",\n";
+        }
+        out += "};\n";
+    } else if (format == PPM) {
+        out = "P6\n" + std::to_string(width) + " " + std::to_string(height) + "\n255\n";
+        out.reserve(out.size() + 3 * ratios.size());
+        unsigned char rgb[3];
+        for (const double ratio : ratios) {
+            colorRGB(colorIndex(ratio, maxR), rgb);
+            out.append(reinterpret_cast<const char *>(rgb), 3);
+        }
+    } else {
+        // 8-bit palette image, every row filtered with None
+        std::string header, palette, raw;
+        putBigEndian(header, width);
+        putBigEndian(header, height);
+        header += std::string("\x08\x03\x00\x00\x00", 5);
+        unsigned char rgb[3];
+        for (unsigned i = 0; i < numColors; ++i) {
+            colorRGB(i, rgb);
+            palette.append(reinterpret_cast<const char *>(rgb), 3);
+        }
+        raw.reserve(static_cast<std::size_t>(height) * (width + 1));
+        for (unsigned j = 0; j < height; ++j) {
+            raw.push_back('\0');
+            for (unsigned i = 0; i < width; ++i) {
+                raw.push_back(static_cast<char>(colorIndex(ratios[j * width + i], maxR)));
+            }
+        }
+        out = "\x89PNG\r\n\x1a\n";
+        pngChunk(out, "IHDR", header);
+        pngChunk(out, "PLTE", palette);
+        pngChunk(out, "IDAT", zlibStream(raw));
+        pngChunk(out, "IEND", std::string());
+    }
+
+    std::ofstream outfile((basename + extension(format)).c_str(), std::ios::binary);
+    outfile.write(out.data(), static_cast<std::streamsize>(out.size()));
+    return outfile.good();
+}
+
+//@brief: the ratio of a gcell is the mean of its horizontal and vertical usage over
+//        capacity, summed over the layers. With `layer`, only the directions that have
+//        an edge on that layer count. A blocked direction counts its usage as if it had
+//        a capacity of 1.
+CongestionMap SimpleGR::congestionMap(unsigned downsample, IdType layer) const
+{
+    GR_PROFILE_SCOPE("congestionMap");
+
+    const unsigned scale = std::max(1U, downsample);
+    const IdType cellsX = gcellArrSzX - 1, cellsY = gcellArrSzY - 1;
+    const IdType zLo = layer == NULLID ? 0 : layer, zHi = layer == NULLID ? numLayers : layer + 1;
+
+    CongestionMap map;
+    map.width = (cellsX + scale - 1) / scale;
+    map.height = (cellsY + scale - 1) / scale;
+    map.ratios.assign(static_cast<std::size_t>(map.width) * map.height, 0.);
+
+    auto ratio = [](double usage, double capacity) { return capacity > 0. ? usage / capacity : usage; };
+
+    parallelFor(map.height, resolveThreads(params.threads), [&](std::size_t row, unsigned) {
+        double *pixels = &map.ratios[row * map.width];
+        // the top row of pixels shows the top row of gcells
+        const IdType yHi = cellsY - static_cast<IdType>(row) * scale;
+        const IdType yLo = yHi > scale ? yHi - scale : 0;
+        for (IdType y = yLo; y < yHi; ++y) {
+            for (IdType x = 0; x < cellsX; ++x) {
+                double xUsage = 0., xCap = 0., yUsage = 0., yCap = 0.;
+                bool xEdge = false, yEdge = false;
+                for (IdType z = zLo; z < zHi; ++z) {
+                    const GCell &gcell = gcellArr3D[z][y][x];
+                    if (gcell.incX != NULLID) {
+                        xUsage += grEdgeArr[gcell.incX].usage;
+                        xCap += grEdgeArr[gcell.incX].capacity;
+                        xEdge = true;
+                    }
+                    if (gcell.incY != NULLID) {
+                        yUsage += grEdgeArr[gcell.incY].usage;
+                        yCap += grEdgeArr[gcell.incY].capacity;
+                        yEdge = true;
+                    }
+                }
+                double value = 0.5 * (ratio(xUsage, xCap) + ratio(yUsage, yCap));
+                if (layer != NULLID && xEdge != yEdge) {
+                    value = xEdge ? ratio(xUsage, xCap) : ratio(yUsage, yCap);
+                }
+                double &pixel = pixels[x / scale];
+                pixel = std::max(pixel, value);
+            }
+        }
+    });
+    return map;
+}
+
+void SimpleGR::plotCongestion(const std::string &filename, CongestionMap::Format format, unsigned downsample)
+{
+    using namespace std;
+
+    const CongestionMap map = congestionMap(downsample);
+    cout << "maxratio was " << map.maxRatio() << endl;
+
+    const string fullfilename = filename + CongestionMap::extension(format);
+    if (map.write(filename, format)) {
+        cout << "Wrote " << map.width << "x" << map.height << " congestion map to `" << fullfilename << "'" << endl;
+    } else {
+        cout << "Could not write `" << fullfilename << "'" << endl;
+    }
+}
+
+//@brief: with -congestionMap, write the congestion map of all layers and of each layer
+//        alone as <base>.<phase>.* and <base>.<phase>.layer<n>.*
+void SimpleGR::writeCongestionMaps(const char *phase)
+{
+    using namespace std;
+
+    if (params.congestionMapFile.empty()) { return; }
+    GR_PROFILE_SCOPE("writeCongestionMaps");
+
+    const string base = params.congestionMapFile + "." + phase;
+    const CongestionMap map = congestionMap(params.mapDownsample);
+    if (movieScale == 0.) { movieScale = map.maxRatio(); }
+
+    bool written = map.write(base, params.mapFormat);
+    for (IdType z = 0; z < numLayers; ++z) {
+        written = congestionMap(params.mapDownsample, z).write(base + ".layer" + to_string(z + 1), params.mapFormat)
+                  && written;
+    }
+    if (written) {
+        cout << "Wrote congestion maps to `" << base << ".*" << CongestionMap::extension(params.mapFormat) << "'"
+             << endl;
+    } else {
+        cout << "Could not write congestion maps to `" << base << ".*'" << endl;
+    }
+}
+
+//@brief: with -congestionMovie, write the congestion map after RRR iteration `iteration`
+//        as <base>.rrr<iteration>.*, colored on the scale of the first map written
+void SimpleGR::writeCongestionFrame(unsigned iteration)
+{
+    using namespace std;
+
+    if (!params.congestionMovie) { return; }
+    GR_PROFILE_SCOPE("writeCongestionMaps");
+
+    CongestionMap map = congestionMap(params.mapDownsample);
+    map.scale = movieScale;
+
+    char frame[32];
+    snprintf(frame, sizeof(frame), ".rrr%03u", iteration);
+    if (!map.write(params.congestionMapFile + frame, params.mapFormat)) {
+        cout << "Could not write congestion map `" << params.congestionMapFile << frame
+             << CongestionMap::extension(params.mapFormat) << "'" << endl;
+    }
+}
@@ -0,0 +1,248 @@
+#include <algorithm>
+#include <cmath>
+#include <ostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Generator.h"
+
+// detailed coordinates of one gcell, pins are placed in the gcell centers
+static constexpr uint32_t gcellPitch = 10;
+
+DesignSpec::DesignSpec(void)
+    : sizeX(256), sizeY(256), numNets(20000), lengthDist(GeometricLength), meanLength(8.), maxLength(64),
+      blockageDensity(0.), horizCap(10), vertCap(10), capProfile(UniformCap), capDepth(0.5), seed(1)
+{}
+
+bool DesignSpec::parseLengthDist(const std::string &name, LengthDist &dist)
+{
+    if (name == "uniform") {
+        dist = UniformLength;
+    } else if (name == "geometric") {
+        dist = GeometricLength;
+    } else if (name == "mixed") {
+        dist = MixedLength;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+bool DesignSpec::parseCapProfile(const std::string &name, CapProfile &profile)
+{
+    if (name == "uniform") {
+        profile = UniformCap;
+    } else if (name == "center") {
+        profile = CenterCap;
+    } else if (name == "random") {
+        profile = RandomCap;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+namespace {
+
+class DesignWriter
+{
+  public:
+    explicit DesignWriter(const DesignSpec &spec) : spec_(spec), rng_(spec.seed) {}
+
+    void write(std::ostream &out)
+    {
+        placeBlockages();
+        assignCapacities();
+
+        out << "grid " << spec_.sizeX << " " << spec_.sizeY << " 2\n";
+        out << "vertical capacity 0 " << spec_.vertCap << "\n";
+        out << "horizontal capacity " << spec_.horizCap << " 0\n";
+        out << "minimum width 1 1\n";
+        out << "minimum spacing 1 1\n";
+        out << "via spacing 1 1\n";
+        out << "0 0 " << gcellPitch << " " << gcellPitch << "\n";
+        out << "num net " << spec_.numNets << "\n";
+        for (uint32_t i = 0; i < spec_.numNets; ++i) { writeNet(out, i); }
+        writeAdjustments(out);
+    }
+
+  private:
+    const DesignSpec &spec_;
+    std::mt19937 rng_;
+    std::vector<char> blocked_;// per gcell, set if a macro covers it
+    // capacity of the horizontal edge (x, y)-(x+1, y) and vertical edge (x, y)-(x, y+1)
+    std::vector<uint32_t> horizCaps_;
+    std::vector<uint32_t> vertCaps_;
+
+    double uniform01(void) { return std::uniform_real_distribution<double>(0., 1.)(rng_); }
+    uint32_t uniformInt(uint32_t lo, uint32_t hi) { return std::uniform_int_distribution<uint32_t>(lo, hi)(rng_); }
+
+    bool blocked(uint32_t x, uint32_t y) const
+    {
+        return blocked_[static_cast<std::size_t>(y) * spec_.sizeX + x] != 0;
+    }
+
+    //@brief: drop macros of random size until the requested area is covered
+    void placeBlockages(void)
+    {
+        const double dieArea = static_cast<double>(spec_.sizeX) * static_cast<double>(spec_.sizeY);
+        const double target = std::min(0.9, std::max(0., spec_.blockageDensity)) * dieArea;
+        const uint32_t maxW = std::max(1U, spec_.sizeX / 8);
+        const uint32_t maxH = std::max(1U, spec_.sizeY / 8);
+
+        blocked_.assign(static_cast<std::size_t>(spec_.sizeX) * spec_.sizeY, 0);
+        double area = 0.;
+        while (area < target) {
+            const uint32_t w = uniformInt(1, maxW);
+            const uint32_t h = uniformInt(1, maxH);
+            const uint32_t x = uniformInt(0, spec_.sizeX - w);
+            const uint32_t y = uniformInt(0, spec_.sizeY - h);
+            for (uint32_t j = y; j < y + h; ++j) {
+                for (uint32_t i = x; i < x + w; ++i) {
+                    char &c = blocked_[static_cast<std::size_t>(j) * spec_.sizeX + i];
+                    if (!c) {
+                        c = 1;
+                        area += 1.;
+                    }
+                }
+            }
+        }
+    }
+
+    //@brief: fraction of the default capacity the profile keeps at gcell (x, y)
+    double profileScale(uint32_t x, uint32_t y)
+    {
+        const double depth = std::min(1., std::max(0., spec_.capDepth));
+        switch (spec_.capProfile) {
+        case DesignSpec::UniformCap:
+            return 1.;
+        case DesignSpec::CenterCap: {
+            // gaussian dip centered on the die
+            const double dx = (static_cast<double>(x) - 0.5 * spec_.sizeX) / (0.25 * spec_.sizeX);
+            const double dy = (static_cast<double>(y) - 0.5 * spec_.sizeY) / (0.25 * spec_.sizeY);
+            return 1. - depth * std::exp(-0.5 * (dx * dx + dy * dy));
+        }
+        case DesignSpec::RandomCap:
+            return 1. - depth * uniform01();
+        }
+        return 1.;
+    }
+
+    void assignCapacities(void)
+    {
+        const std::size_t cells = static_cast<std::size_t>(spec_.sizeX) * spec_.sizeY;
+        horizCaps_.assign(cells, spec_.horizCap);
+        vertCaps_.assign(cells, spec_.vertCap);
+
+        // edge capacities are stored in 8 bits by the router
+        auto scaled = [](uint32_t cap, double scale) {
+            return std::min(255U, static_cast<uint32_t>(std::lround(static_cast<double>(cap) * scale)));
+        };
+
+        for (uint32_t y = 0; y < spec_.sizeY; ++y) {
+            for (uint32_t x = 0; x < spec_.sizeX; ++x) {
+                const std::size_t idx = static_cast<std::size_t>(y) * spec_.sizeX + x;
+                const double scale = profileScale(x, y);
+                horizCaps_[idx] = scaled(spec_.horizCap, scale);
+                vertCaps_[idx] = scaled(spec_.vertCap, scale);
+
+                // Macros block the horizontal layer completely and half of the vertical
+                // layer, so every gcell stays reachable over the top.
+                if (blocked(x, y)) {
+                    horizCaps_[idx] = 0;
+                    vertCaps_[idx] = std::max(std::min(2U, spec_.vertCap), vertCaps_[idx] / 2);
+                } else {
+                    // keep at least one track so pins outside macros are always reachable
+                    horizCaps_[idx] = std::max(std::min(2U, spec_.horizCap), horizCaps_[idx]);
+                    vertCaps_[idx] = std::max(std::min(2U, spec_.vertCap), vertCaps_[idx]);
+                }
+            }
+        }
+    }
+
+    uint32_t drawLength(void)
+    {
+        const uint32_t maxLen = std::max(1U, std::min(spec_.maxLength, spec_.sizeX + spec_.sizeY - 2));
+        auto geometric = [&]() {
+            const double p = 1. / std::max(1., spec_.meanLength);
+            return std::min(maxLen, 1U + std::geometric_distribution<uint32_t>(p)(rng_));
+        };
+        switch (spec_.lengthDist) {
+        case DesignSpec::UniformLength:
+            return uniformInt(1, maxLen);
+        case DesignSpec::GeometricLength:
+            return geometric();
+        case DesignSpec::MixedLength:
+            // mostly local nets plus a tail of long global ones
+            return uniform01() < 0.9 ? geometric() : uniformInt(1, maxLen);
+        }
+        return 1;
+    }
+
+    //@brief: pick a random gcell outside every blockage
+    void drawPin(uint32_t &x, uint32_t &y)
+    {
+        for (unsigned attempt = 0; attempt < 64; ++attempt) {
+            x = uniformInt(0, spec_.sizeX - 1);
+            y = uniformInt(0, spec_.sizeY - 1);
+            if (!blocked(x, y)) { return; }
+        }
+    }
+
+    static uint32_t step(uint32_t from, uint32_t delta, bool negative, uint32_t size)
+    {
+        // walk in the chosen direction, reflecting off the die boundary
+        int64_t to = static_cast<int64_t>(from) + (negative ? -static_cast<int64_t>(delta) : delta);
+        if (to < 0) { to = -to; }
+        if (to >= static_cast<int64_t>(size)) { to = 2 * (static_cast<int64_t>(size) - 1) - to; }
+        return static_cast<uint32_t>(std::min<int64_t>(std::max<int64_t>(to, 0), static_cast<int64_t>(size) - 1));
+    }
+
+    void writeNet(std::ostream &out, uint32_t id)
+    {
+        uint32_t x1, y1;
+        drawPin(x1, y1);
+
+        uint32_t x2 = x1, y2 = y1;
+        for (unsigned attempt = 0; attempt < 16 && x2 == x1 && y2 == y1; ++attempt) {
+            const uint32_t len = drawLength();
+            const uint32_t dx = uniformInt(0, len);
+            x2 = step(x1, dx, uniform01() < 0.5, spec_.sizeX);
+            y2 = step(y1, len - dx, uniform01() < 0.5, spec_.sizeY);
+            if (blocked(x2, y2)) { x2 = x1, y2 = y1; }
+        }
+
+        out << "n" << id << " " << id << " 2 1\n";
+        out << x1 * gcellPitch + gcellPitch / 2 << " " << y1 * gcellPitch + gcellPitch / 2 << " 1\n";
+        out << x2 * gcellPitch + gcellPitch / 2 << " " << y2 * gcellPitch + gcellPitch / 2 << " 1\n";
+    }
+
+    void writeAdjustments(std::ostream &out)
+    {
+        std::vector<std::string> lines;
+        for (uint32_t y = 0; y < spec_.sizeY; ++y) {
+            for (uint32_t x = 0; x < spec_.sizeX; ++x) {
+                const std::size_t idx = static_cast<std::size_t>(y) * spec_.sizeX + x;
+                if (x + 1 < spec_.sizeX && horizCaps_[idx] != spec_.horizCap) {
+                    lines.push_back(std::to_string(x) + " " + std::to_string(y) + " 1 " + std::to_string(x + 1) + " "
+                                    + std::to_string(y) + " 1 " + std::to_string(horizCaps_[idx]));
+                }
+                if (y + 1 < spec_.sizeY && vertCaps_[idx] != spec_.vertCap) {
+                    lines.push_back(std::to_string(x) + " " + std::to_string(y) + " 2 " + std::to_string(x) + " "
+                                    + std::to_string(y + 1) + " 2 " + std::to_string(vertCaps_[idx]));
+                }
+            }
+        }
+        out << "\n" << lines.size() << "\n";
+        for (const auto &line : lines) { out << line << "\n"; }
+    }
+};
+
+}// namespace
+
+void writeDesign(std::ostream &out, const DesignSpec &spec)
+{
+    DesignWriter writer(spec);
+    writer.write(out);
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+//@brief: parameters of a synthetic design. The generated design follows the layout
+//        SimpleGR::buildGrid expects: 2 layers, horizontal routing on layer 1 and
+//        vertical routing on layer 2, vias everywhere.
+class DesignSpec
+{
+  public:
+    // Distribution of the pin-to-pin Manhattan distance of the generated nets
+    enum LengthDist { UniformLength, GeometricLength, MixedLength };
+    // How the routing capacity varies over the die
+    enum CapProfile { UniformCap, CenterCap, RandomCap };
+
+    uint32_t sizeX;
+    uint32_t sizeY;
+    uint32_t numNets;
+
+    LengthDist lengthDist;
+    double meanLength;// mean net length (gcells) for the geometric part
+    uint32_t maxLength;// upper bound on net length, also the range of the uniform part
+
+    double blockageDensity;// fraction of the die covered by blockages (macros)
+
+    uint32_t horizCap;// default capacity of a horizontal edge on layer 1
+    uint32_t vertCap;// default capacity of a vertical edge on layer 2
+    CapProfile capProfile;
+    double capDepth;// how much the profile may take away from the default capacity, 0..1
+
+    uint32_t seed;
+
+    DesignSpec(void);
+
+    static bool parseLengthDist(const std::string &name, LengthDist &dist);
+    static bool parseCapProfile(const std::string &name, CapProfile &profile);
+};
+
+//@brief: write a valid .gr design for `spec` to `out`. The same spec always produces
+//        the same file.
+void writeDesign(std::ostream &out, const DesignSpec &spec);
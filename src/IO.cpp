@@ -5,45 +5,297 @@
 #include <cstdlib>
 #include <exception>
 #include <fstream>
+#include <initializer_list>
 #include <iostream>
-#include <map>
+#include <new>
 #include <string>
 #include <vector>
 
+#ifdef __unix__
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "Profiler.h"
 #include "SimpleGR.h"
 
-void expect(std::string s1, std::string s2)
+MappedFile::~MappedFile()
 {
-    if (s1 != s2) {
-        std::cout << "Parsing error. Expected `" << s2 << "' but got `" << s1 << "' instead" << std::endl;
-        std::terminate();
+#ifdef __unix__
+    if (mapped_) { munmap(const_cast<char *>(data_), size_); }
+#endif
+}
+
+bool MappedFile::open(const char *filename)
+{
+#ifdef __unix__
+    const int fd = ::open(filename, O_RDONLY);
+    if (fd < 0) { return false; }
+    struct stat status;
+    if (fstat(fd, &status) == 0 && status.st_size > 0) {
+        void *map = mmap(nullptr, static_cast<std::size_t>(status.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        if (map != MAP_FAILED) {
+            madvise(map, static_cast<std::size_t>(status.st_size), MADV_SEQUENTIAL);
+            data_ = static_cast<const char *>(map);
+            size_ = static_cast<std::size_t>(status.st_size);
+            mapped_ = true;
+        }
     }
+    close(fd);
+    if (mapped_) { return true; }
+#endif
+    std::ifstream infile(filename, std::ios::binary | std::ios::ate);
+    if (!infile.good()) { return false; }
+    buffer_.resize(static_cast<std::size_t>(std::max<std::streamoff>(0, infile.tellg())));
+    infile.seekg(0);
+    infile.read(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+    data_ = buffer_.data();
+    size_ = buffer_.size();
+    return true;
+}
+
+bool TextScanner::open(const char *filename)
+{
+    file_.open(filename, std::ios::binary);
+    if (!file_.good()) { return false; }
+    buffer_.resize(blockSize);
+    data_ = buffer_.data();
+    fill();
+    return true;
+}
+
+bool TextScanner::fill(void)
+{
+    if (eof_) { return false; }
+    std::copy(buffer_.begin() + static_cast<std::ptrdiff_t>(pos_), buffer_.begin() + static_cast<std::ptrdiff_t>(end_),
+        buffer_.begin());
+    end_ -= pos_;
+    pos_ = 0;
+    // a word longer than the buffer
+    if (end_ == buffer_.size()) { buffer_.resize(2 * buffer_.size()); }
+    data_ = buffer_.data();
+    file_.read(buffer_.data() + end_, static_cast<std::streamsize>(buffer_.size() - end_));
+    const std::size_t count = static_cast<std::size_t>(file_.gcount());
+    end_ += count;
+    eof_ = !file_.good();
+    return count > 0;
+}
+
+void TextScanner::skipSpace(void)
+{
+    do {
+        while (pos_ < end_ && isSpace(data_[pos_])) { ++pos_; }
+    } while (pos_ == end_ && fill());
 }
 
-//@brief: load a design benchmark into memory... comment me
-void SimpleGR::parseInput()
+char TextScanner::peek(void)
+{
+    if (pos_ == end_ && !fill()) { return '\0'; }
+    return data_[pos_];
+}
+
+void TextScanner::skipLine(void)
+{
+    do {
+        while (pos_ < end_) {
+            if (data_[pos_++] == '\n') { return; }
+        }
+    } while (fill());
+}
+
+std::string_view TextScanner::word(void)
+{
+    skipSpace();
+    std::size_t length = 0;
+    for (;;) {
+        while (pos_ + length < end_ && !isSpace(data_[pos_ + length])) { ++length; }
+        if (pos_ + length < end_ || !fill()) { break; }
+    }
+    if (length == 0) { failed_ = true; }
+    const std::string_view w(data_ + pos_, length);
+    pos_ += length;
+    return w;
+}
+
+TextScanner &TextScanner::operator>>(std::string &value)
+{
+    const std::string_view w = word();
+    if (!w.empty()) { value.assign(w); }
+    return *this;
+}
+
+TextScanner &TextScanner::operator>>(char &value)
+{
+    skipSpace();
+    if (pos_ == end_) {
+        failed_ = true;
+    } else {
+        value = data_[pos_++];
+    }
+    return *this;
+}
+
+std::string_view TextScanner::line(void)
+{
+    std::size_t length = 0;
+    for (;;) {
+        while (pos_ + length < end_ && data_[pos_ + length] != '\n') { ++length; }
+        if (pos_ + length < end_ || !fill()) { break; }
+    }
+    const std::string_view l(data_ + pos_, length);
+    pos_ += length < end_ - pos_ ? length + 1 : length;
+    return l;
+}
+
+void TextScanner::badNumber(void)
+{
+    if (pos_ == end_) {
+        failed_ = true;
+        return;
+    }
+    const std::string message = "Expected a number but got `" + std::string(word()) + "' instead";
+    if (!fatal_) {
+        if (!failed_) { error_ = message; }
+        failed_ = true;
+        return;
+    }
+    std::cout << "Parsing error. " << message << std::endl;
+    std::terminate();
+}
+
+//@brief: read the capacity adjustments at the end of a design file into the capacity
+//        of every wire edge, by edge ID (see buildGrid). A later adjustment of the same
+//        edge overrides an earlier one; without adjustments `wireCaps` is left empty.
+//        False on a bad adjustment, with the reason in parseError().
+bool SimpleGR::readAdjustments(TextScanner &infile, std::vector<CapType> &wireCaps)
 {
     using namespace std;
 
-    if (params.inputFile.empty()) {
-        cout << "Error: Unspecified design file" << endl;
-        exit(0);
+    const IdType sizeX = gcellArrSzX, sizeY = gcellArrSzY;
+    const IdType numHoriz = sizeY * (sizeX - 1);
+
+    // the adjustments are optional, but something else than their count is an error
+    unsigned capacityChanges = 0;
+    infile >> capacityChanges;
+    if (!infile.error().empty()) { return parseFailed(infile.error()); }
+    wireCaps.clear();
+    if (capacityChanges == 0) { return true; }
+    wireCaps.assign(static_cast<size_t>(numHoriz) + sizeX * (sizeY - 1), vertCaps[1]);
+    fill(wireCaps.begin(), wireCaps.begin() + numHoriz, horizCaps[0]);
+
+    for (unsigned i = 0; i < capacityChanges; ++i) {
+        CoordType x1 = 0, y1 = 0, z1 = 0, x2 = 0, y2 = 0, z2 = 0;
+        CapType newCap = 0;
+        infile >> x1 >> y1 >> z1 >> x2 >> y2 >> z2 >> newCap;
+        if (!infile.good()) { return parseFailed("Bad capacity adjustment"); }
+        --z1;
+        --z2;
+
+        const bool horiz = y1 == y2 && max(x1, x2) == min(x1, x2) + 1;
+        const bool vert = x1 == x2 && max(y1, y2) == min(y1, y2) + 1;
+        if ((!horiz && !vert) || z1 != z2 || z1 >= numLayers || max(x1, x2) >= sizeX || max(y1, y2) >= sizeY) {
+            return parseFailed("Bad capacity adjustment");
+        }
+        // layer 0 only has horizontal edges and layer 1 vertical ones
+        if (horiz != (z1 == 0)) {
+            if (newCap != 0) { return parseFailed("Adjusting capacity on a previously non-existing edge"); }
+            continue;
+        }
+        if (horiz) {
+            wireCaps[y1 * (sizeX - 1) + min(x1, x2)] = newCap;
+        } else {
+            wireCaps[numHoriz + x1 * (sizeY - 1) + min(y1, y2)] = newCap;
+        }
     }
-    ifstream infile(params.inputFile.c_str());
+    return true;
+}
 
-    if (!infile.good()) {
-        cout << "Error: Could not open `" << params.inputFile << "' for reading" << endl;
-        exit(0);
+//@brief: print why the design could not be read and keep it for parseError()
+bool SimpleGR::parseFailed(const std::string &reason)
+{
+    parseMessage = reason;
+    std::cout << "Error: " << reason << std::endl;
+    return false;
+}
+
+//@brief: load a design benchmark into memory; false if it cannot be read or is
+//        malformed, with the reason in parseError()
+bool SimpleGR::parseInput()
+{
+    using namespace std;
+
+    GR_PROFILE_PHASE("parseInput");
+    const ScopedPhase phase(runReport, "parseInput");
+
+    if (params.inputFile.empty()) { return parseFailed("Unspecified design file"); }
+    TextScanner infile;
+
+    if (!infile.open(params.inputFile.c_str())) {
+        return parseFailed("Could not open `" + params.inputFile + "' for reading");
     } else {
         cout << "Reading from `" << params.inputFile << "' ..." << endl;
     }
+    // a bogus net count or grid size must not end the process either
+    try {
+        return parseDesign(infile, true);
+    } catch (const bad_alloc &) {
+        return parseFailed("Out of memory reading `" + params.inputFile + "'");
+    }
+}
 
-    string textstring;
+//@brief: parse a design from the text of a .gr file, for the library interface
+bool SimpleGR::parseInput(std::string_view design)
+{
+    using namespace std;
+
+    GR_PROFILE_PHASE("parseInput");
+    const ScopedPhase phase(runReport, "parseInput");
+
+    cout << "Reading design from memory ..." << endl;
+    TextScanner infile(design);
+    try {
+        return parseDesign(infile, true);
+    } catch (const bad_alloc &) {
+        return parseFailed("Out of memory reading the design");
+    }
+}
+
+//@brief: read a design and build its grid, for routing or (`forRouting` false) for the
+//        mapper and the verifier. A malformed design is reported rather than ending the
+//        process, so that the library and the routing server outlive it; the SimpleGR
+//        is unusable after a failure.
+bool SimpleGR::parseDesign(TextScanner &infile, bool forRouting)
+{
+    using namespace std;
+
+    infile.setFatal(false);
+    // the next words must be `expected'
+    const auto keywords = [&](initializer_list<const char *> expected) {
+        for (const char *keyword : expected) {
+            const string_view word = infile.word();
+            if (word != keyword) {
+                return parseFailed("Expected `" + string(keyword) + "' but got `" + string(word) + "' instead");
+            }
+        }
+        return true;
+    };
+    // the numbers read since the last check were all there
+    const auto numbersRead = [&]() {
+        if (infile.good()) { return true; }
+        return parseFailed(infile.error().empty() ? "Unexpected end of file" : infile.error());
+    };
 
     // Capture the layer dimensions (x, y) and the number of layers
-    infile >> textstring;
-    expect(textstring, string("grid"));
+    if (!keywords({ "grid" })) { return false; }
     infile >> gcellArrSzX >> gcellArrSzY >> numLayers;
+    if (!numbersRead()) { return false; }
+    if (numLayers != 2 || gcellArrSzX == 0 || gcellArrSzY == 0
+        || static_cast<uint64_t>(gcellArrSzX) * gcellArrSzY * numLayers >= NULLID) {
+        return parseFailed("Unsupported grid " + to_string(gcellArrSzX) + "x" + to_string(gcellArrSzY) + "x"
+                           + to_string(numLayers) + ", the grid must have 2 layers");
+    }
 
     // always true for this assignment
     if (numLayers <= 2) { params.layerAssign = false; }
@@ -51,23 +303,17 @@ void SimpleGR::parseInput()
     cout << "grid size " << gcellArrSzX << "x" << gcellArrSzY << endl;
 
     // for each layer, get the vertical capacity (for wires)
-    infile >> textstring;
-    expect(textstring, string("vertical"));
-    infile >> textstring;
-    expect(textstring, string("capacity"));
+    if (!keywords({ "vertical", "capacity" })) { return false; }
     for (unsigned i = 0; i < numLayers; ++i) {
-        unsigned cap;
+        unsigned cap = 0;
         infile >> cap;
         vertCaps.push_back(cap);
     }
 
     // for each layer, get the horizontal capacity (for wires)
-    infile >> textstring;
-    expect(textstring, string("horizontal"));
-    infile >> textstring;
-    expect(textstring, string("capacity"));
+    if (!numbersRead() || !keywords({ "horizontal", "capacity" })) { return false; }
     for (unsigned i = 0; i < numLayers; ++i) {
-        unsigned cap;
+        unsigned cap = 0;
         infile >> cap;
         horizCaps.push_back(cap);
     }
@@ -76,86 +322,87 @@ void SimpleGR::parseInput()
     // to calculate this for a layer:
     // for l in layers:
     //      l.routing_demand = l.min_width + l.min_spacing
-    infile >> textstring;
-    expect(textstring, string("minimum"));
-    infile >> textstring;
-    expect(textstring, string("width"));
-
+    if (!numbersRead() || !keywords({ "minimum", "width" })) { return false; }
     for (unsigned i = 0; i < numLayers; ++i) {
-        unsigned minwidth;
+        unsigned minwidth = 0;
         infile >> minwidth;
         minWidths.push_back(minwidth);
     }
 
-    infile >> textstring;
-    expect(textstring, string("minimum"));
-    infile >> textstring;
-    expect(textstring, string("spacing"));
-
+    if (!numbersRead() || !keywords({ "minimum", "spacing" })) { return false; }
     for (unsigned i = 0; i < numLayers; ++i) {
-        unsigned minspacing;
+        unsigned minspacing = 0;
         infile >> minspacing;
         minSpacings.push_back(minspacing);
     }
 
     // Read in via spacing, but it won't be used
-    infile >> textstring;
-    expect(textstring, string("via"));
-    infile >> textstring;
-    expect(textstring, string("spacing"));
+    if (!numbersRead() || !keywords({ "via", "spacing" })) { return false; }
     for (unsigned i = 0; i < numLayers; ++i) {
-        unsigned viaspacing;
+        unsigned viaspacing = 0;
         infile >> viaspacing;
         viaSpacings.push_back(viaspacing);
     }
 
     // get the detail coordinates and sizes
     infile >> minX >> minY >> gcellWidth >> gcellHeight;
+    if (!numbersRead()) { return false; }
+    if (gcellWidth == 0 || gcellHeight == 0) { return parseFailed("The gcells must not be empty"); }
 
     halfWidth = gcellWidth >> 1;
     halfHeight = gcellHeight >> 1;
 
     // read in the expected number of nets and allocate that much space
     // in the net array
-    unsigned numNets;
-    infile >> textstring;
-    expect(textstring, string("num"));
-    infile >> textstring;
-    expect(textstring, string("net"));
+    unsigned numNets = 0;
+    if (!keywords({ "num", "net" })) { return false; }
     infile >> numNets;
+    if (!numbersRead()) { return false; }
     grNetArr.reserve(numNets);
+    // names of the nets that are not routed, indexed after the GR nets
+    vector<string> flatNames;
+
+    // translate detailed pin coords to global grid coords; false for a pin outside the grid
+    const auto pinGCell = [&](double pinX, double pinY, unsigned layer, Point &gcell) {
+        const double x = floor((pinX - minX) / gcellWidth);
+        const double y = floor((pinY - minY) / gcellHeight);
+        if (!(x >= 0. && x < gcellArrSzX && y >= 0. && y < gcellArrSzY) || layer < 1 || layer > numLayers) {
+            return false;
+        }
+        gcell.setCoord(static_cast<CoordType>(x), static_cast<CoordType>(y), layer - 1);
+        return true;
+    };
 
     // read in all the nets
     for (unsigned i = 0; i < numNets; ++i) {
         Net newNet;
-        unsigned numPins;
-        unsigned wireWidth;
+        unsigned numPins = 0;
+        unsigned wireWidth = 0;
         string name;
-        IdType dbId;
+        IdType dbId = 0;
 
         // grab the name, database id, number of pins, and wire width
         // for the net
         infile >> name >> dbId >> numPins >> wireWidth;
 
         // In this project, all nets have exactly 2 pins.
-        assert(numPins == 2);
-
-        double pinX, pinY;
-        unsigned layer;
+        if (infile.good() && numPins != 2) {
+            return parseFailed("Net `" + name + "' has " + to_string(numPins) + " pins, only 2 are supported");
+        }
 
-        // get the (x,y) coordinate of the first pin
-        infile >> pinX >> pinY >> layer;
-        // translate detailed pin coords to global grid coords
-        newNet.gCellOne.x = static_cast<unsigned>(floor((pinX - minX) / gcellWidth));
-        newNet.gCellOne.y = static_cast<unsigned>(floor((pinY - minY) / gcellHeight));
-        newNet.gCellOne.z = layer - 1;
+        double pinX1 = 0., pinY1 = 0., pinX2 = 0., pinY2 = 0.;
+        unsigned layer1 = 0, layer2 = 0;
+        infile >> pinX1 >> pinY1 >> layer1 >> pinX2 >> pinY2 >> layer2;
 
-        // get the (x,y) coordinate of the second pin
-        infile >> pinX >> pinY >> layer;
-        // translate detailed pin coords to global grid coords
-        newNet.gCellTwo.x = static_cast<unsigned>(floor((pinX - minX) / gcellWidth));
-        newNet.gCellTwo.y = static_cast<unsigned>(floor((pinY - minY) / gcellHeight));
-        newNet.gCellTwo.z = layer - 1;
+        if (!infile.good()) {
+            if (infile.error().empty()) {
+                return parseFailed("Unexpected end of file after " + to_string(i) + " nets");
+            }
+            return parseFailed(infile.error() + " in net `" + name + "'");
+        }
+        if (!pinGCell(pinX1, pinY1, layer1, newNet.gCellOne) || !pinGCell(pinX2, pinY2, layer2, newNet.gCellTwo)) {
+            return parseFailed("Net `" + name + "' has a pin outside the grid");
+        }
 
         // if the pins are in the same cell, we will ignore them for the
         // purposes of this assignment
@@ -164,282 +411,86 @@ void SimpleGR::parseInput()
 
             newNet.id = static_cast<IdType>(grNetArr.size());
             grNetArr.push_back(newNet);
-            netNameToPtrMap[name] = &grNetArr.back();
-            netNameArr.push_back(name);
+            netNames.add(name, newNet.id);
             netDBIdArr.push_back(dbId);
         } else {
-            netNameToPtrMap[name] = NULL;
+            flatNames.push_back(name);
         }
     }
+    for (const string &name : flatNames) { netNames.add(name, NULLID); }
+    netNames.build();
 
     cout << "read in " << grNetArr.size() << " GR nets from " << numNets << " nets design" << endl;
 
-    // build the routing grid graph
-    buildGrid();
-
-    unsigned capacityChanges;
-    infile >> capacityChanges;
-
-    // Start to apply the capacity adjustments
-    for (unsigned i = 0; i < capacityChanges; ++i) {
-        unsigned gridCol1, gridRow1, layer1, gridCol2, gridRow2, layer2, newCap;
-
-        infile >> gridCol1 >> gridRow1 >> layer1 >> gridCol2 >> gridRow2 >> layer2 >> newCap;
-
-        assert(layer1 == layer2);
-        assert(layer1 <= 2);
-        assert(layer2 <= 2);
-
-        // if this is a vertical edges
-        if (gridCol1 == gridCol2) {
-            assert(gridRow1 == gridRow2 + 1 || gridRow1 + 1 == gridRow2);
-
-            if (gcellArr3D[layer1 - 1][min(gridRow1, gridRow2)][gridCol1].incY == NULLID) {
-                if (newCap != 0.) {
-                    cout << "Error: Adjusting capacity on a previously non-existing edge." << endl;
-                    exit(0);
-                }
-            } else {
-                grEdgeArr[gcellArr3D[layer1 - 1][min(gridRow1, gridRow2)][gridCol1].incY].capacity = newCap;
-
-                // if there was an edge here and the new capacity is zero, remove the path
-                // between the vertical edges
-                if (newCap == 0.) {
-                    gcellArr3D[layer1 - 1][min(gridRow1, gridRow2)][gridCol1].incY = NULLID;
-                    gcellArr3D[layer1 - 1][max(gridRow1, gridRow2)][gridCol1].decY = NULLID;
-                }
-            }
-        }
-        // horizontal edges
-        else if (gridRow1 == gridRow2) {
-            assert(gridCol1 == gridCol2 + 1 || gridCol1 + 1 == gridCol2);
-            if (gcellArr3D[layer1 - 1][gridRow1][min(gridCol1, gridCol2)].incX == NULLID) {
-                if (newCap != 0.) {
-                    cout << "Error: Adjusting capacity on a previously non-existing edge." << endl;
-                    std::terminate();
-                }
-            } else {
-                grEdgeArr[gcellArr3D[layer1 - 1][gridRow1][min(gridCol1, gridCol2)].incX].capacity = newCap;
-
-                // if there was an edge here and the new capacity is zero, remove the path
-                // between the horizontal edges
-                if (newCap == 0.) {
-                    gcellArr3D[layer1 - 1][gridRow1][min(gridCol1, gridCol2)].incX = NULLID;
-                    gcellArr3D[layer1 - 1][gridRow1][max(gridCol1, gridCol2)].decX = NULLID;
-                }
-            }
-        }
-        // we don't care about vertical blockages, as we just assume there are vias available
-        else {
-            cout << "Error: Bad capacity adjustment." << endl;
-            std::terminate();
-        }
-    }
-
-    infile.close();
+    // read the capacity adjustments, applied while the routing grid graph is built
+    vector<CapType> wireCaps;
+    if (!readAdjustments(infile, wireCaps)) { return false; }
+    buildGrid(wireCaps, forRouting);
 
     // Initialize the priority queue for maze routing
-    priorityQueue.resize(numLayers * gcellArrSzX * gcellArrSzY);
+    if (forRouting) { priorityQueue.resize(numLayers * gcellArrSzX * gcellArrSzY); }
 
     cout << "CPU time: " << cpuTime() << " seconds" << endl;
+    return true;
 }
 
-void SimpleGR::parseInputMapper(const char *filename)
+//@brief: load a design for the mapper and the verifier, mapped into memory like the
+//        solutions they read; blocked edges stay connected, so that routes over them
+//        still load. False if it cannot be read or is malformed, with the reason in
+//        parseError().
+bool SimpleGR::parseInputMapper(const char *filename)
 {
     using namespace std;
 
-    ifstream infile(filename);
-
-    if (!infile.good()) {
-        cout << "Could not open `" << filename << "' for reading" << endl;
-        exit(0);
+    MappedFile file;
+    if (!file.open(filename)) {
+        return parseFailed("Could not open `" + string(filename) + "' for reading");
     } else {
         cout << "Reading from `" << filename << "' ..." << endl;
     }
-
-    string tmp;
-
-    infile >> tmp;
-    expect(tmp, string("grid"));
-
-    infile >> gcellArrSzX >> gcellArrSzY >> numLayers;
-
-    if (numLayers <= 2) params.layerAssign = false;
-
-    cout << "grid size " << gcellArrSzX << "x" << gcellArrSzY << endl;
-
-    infile >> tmp;
-    expect(tmp, string("vertical"));
-    infile >> tmp;
-    expect(tmp, string("capacity"));
-
-    for (unsigned i = 0; i < numLayers; ++i) {
-        unsigned cap;
-        infile >> cap;
-        vertCaps.push_back(cap);
-    }
-
-    infile >> tmp;
-    expect(tmp, string("horizontal"));
-    infile >> tmp;
-    expect(tmp, string("capacity"));
-
-    for (unsigned i = 0; i < numLayers; ++i) {
-        unsigned cap;
-        infile >> cap;
-        horizCaps.push_back(cap);
-    }
-
-    infile >> tmp;
-    expect(tmp, string("minimum"));
-    infile >> tmp;
-    expect(tmp, string("width"));
-
-    for (unsigned i = 0; i < numLayers; ++i) {
-        unsigned minwidth;
-        infile >> minwidth;
-        minWidths.push_back(minwidth);
+    TextScanner infile(file.text());
+    try {
+        return parseDesign(infile, false);
+    } catch (const bad_alloc &) {
+        return parseFailed("Out of memory reading `" + string(filename) + "'");
     }
-
-    infile >> tmp;
-    expect(tmp, string("minimum"));
-    infile >> tmp;
-    expect(tmp, string("spacing"));
-
-    for (unsigned i = 0; i < numLayers; ++i) {
-        unsigned minspacing;
-        infile >> minspacing;
-        minSpacings.push_back(minspacing);
-    }
-
-    infile >> tmp;
-    expect(tmp, string("via"));
-    infile >> tmp;
-    expect(tmp, string("spacing"));
-
-    for (unsigned i = 0; i < numLayers; ++i) {
-        unsigned viaspacing;
-        infile >> viaspacing;
-        viaSpacings.push_back(viaspacing);
-    }
-
-    infile >> minX >> minY >> gcellWidth >> gcellHeight;
-
-    halfWidth = static_cast<LenType>(trunc(0.5 * gcellWidth));
-    halfHeight = static_cast<LenType>(trunc(0.5 * gcellHeight));
-
-    infile >> tmp;
-    expect(tmp, string("num"));
-    infile >> tmp;
-    expect(tmp, string("net"));
-
-    unsigned numNets;
-
-    infile >> numNets;
-
-    cout << "total nets " << numNets << endl;
-
-    grNetArr.reserve(numNets);
-
-    for (unsigned i = 0; i < numNets; ++i) {
-        Net temp;
-        unsigned wireWidth;
-        unsigned numPins;
-        string name;
-        IdType id;
-
-        infile >> name >> id >> numPins >> wireWidth;
-
-        // For this project, all nets have exactly 2 pins.
-        assert(numPins == 2);
-
-        // translate absolute coords to grid coords
-        double pinX, pinY;
-        unsigned layer;
-
-        infile >> pinX >> pinY >> layer;
-        temp.gCellOne.x = static_cast<unsigned>(floor((pinX - minX) / gcellWidth));
-        temp.gCellOne.y = static_cast<unsigned>(floor((pinY - minY) / gcellHeight));
-        temp.gCellOne.z = layer - 1;
-
-        infile >> pinX >> pinY >> layer;
-        temp.gCellTwo.x = static_cast<unsigned>(floor((pinX - minX) / gcellWidth));
-        temp.gCellTwo.y = static_cast<unsigned>(floor((pinY - minY) / gcellHeight));
-        temp.gCellTwo.z = layer - 1;
-
-        if (temp.gCellOne != temp.gCellTwo) {
-            ++routableNets;
-
-            grNetArr.push_back(temp);
-            netNameToPtrMap[name] = &grNetArr.back();
-            netNameArr.push_back(name);
-            netDBIdArr.push_back(id);
-        } else {
-            netNameToPtrMap[name] = NULL;
-        }
-    }
-
-    // build the routing grid graph
-    buildGrid();
-
-    unsigned capacityChanges;
-    infile >> capacityChanges;
-
-    for (unsigned i = 0; i < capacityChanges; ++i) {
-        unsigned gridCol1, gridRow1, layer1, gridCol2, gridRow2, layer2, newCap;
-
-        infile >> gridCol1 >> gridRow1 >> layer1 >> gridCol2 >> gridRow2 >> layer2 >> newCap;
-
-        assert(layer1 == layer2);
-        if (gridCol1 == gridCol2) {
-            // vert segment
-            assert(gridRow1 == gridRow2 + 1 || gridRow1 + 1 == gridRow2);
-            grEdgeArr[gcellArr3D[layer1 - 1][min(gridRow1, gridRow2)][gridCol1].incY].capacity = newCap;
-        } else if (gridRow1 == gridRow2) {
-            // horiz segment
-            assert(gridCol1 == gridCol2 + 1 || gridCol1 + 1 == gridCol2);
-            grEdgeArr[gcellArr3D[layer1 - 1][gridRow1][min(gridCol1, gridCol2)].incX].capacity = newCap;
-        } else {
-            assert(0);
-        }
-    }
-
-    infile.close();
 }
 
 void SimpleGR::parseSolution(const char *filename)
 {
     using namespace std;
 
-    ifstream infile(filename);
+    TextScanner infile;
 
-    if (!infile.good()) {
+    if (!infile.open(filename)) {
         cout << "Could not open `" << filename << "' for reading" << endl;
         exit(0);
     } else {
         cout << "Reading from `" << filename << "' ..." << endl;
     }
 
-    string netname;
-
-    infile >> netname;
+    string_view netname = infile.word();
 
     while (infile.good()) {
-        if (netNameToPtrMap.find(netname) == netNameToPtrMap.end()) {
+        IdType netId;
+        if (!netNames.find(netname, netId) || netId == NULLID) {
             cout << "unknown net with name `" << netname << "'" << endl;
             exit(0);
         }
 
-        Net &net = *netNameToPtrMap[netname];
+        Net &net = grNetArr[netId];
 
         char junk;
-        string restofline;
-        getline(infile, restofline);
+        infile.skipLine();
 
         while (infile.peek() == '(') {
-            unsigned x1, y1, z1, x2, y2, z2;
+            unsigned x1 = 0, y1 = 0, z1 = 0, x2 = 0, y2 = 0, z2 = 0;
             infile >> junk >> x1 >> junk >> y1 >> junk >> z1 >> junk >> junk >> junk >> x2 >> junk >> y2 >> junk >> z2;
-            getline(infile, restofline);
+            if (!infile.good()) {
+                cout << "Error: Bad segment." << endl;
+                exit(0);
+            }
+            infile.skipLine();
 
             unsigned gcell1x, gcell1y, gcell1z, gcell2x, gcell2y, gcell2z;
 
@@ -504,58 +555,199 @@ void SimpleGR::parseSolution(const char *filename)
             }
         }
 
-        getline(infile, restofline);// the trailing !
+        infile.skipLine();// the trailing !
 
         // read in the next one
-        infile >> netname;
+        netname = infile.word();
     }
 }
 
-void SimpleGR::writeRoutes()
+void SimpleGR::netSegments(IdType netId, std::vector<std::pair<Point, Point>> &segments) const
 {
     using namespace std;
 
-    if (params.outputFile.empty()) { return; }
-    string filename = params.outputFile;
-    ofstream outfile(filename.c_str());
+    vector<IdType> usedEdges(grNetArr[netId].segments);
+    sort(usedEdges.begin(), usedEdges.end());
 
-    if (!outfile.good()) {
-        cout << "Could not open `" << filename << "' for writing." << endl;
-        return;
+    segments.clear();
+    assert(usedEdges.size() > 0);
+    Point startPt(*grEdgeArr[usedEdges[0]].gcell1);
+    Point endPt(*grEdgeArr[usedEdges[0]].gcell2);
+    for (unsigned j = 1; j < usedEdges.size(); ++j) {
+        unsigned prevEdge = usedEdges[j - 1];
+        unsigned currEdge = usedEdges[j];
+
+        if (grEdgeArr[prevEdge].type != grEdgeArr[currEdge].type
+            || grEdgeArr[prevEdge].gcell2 != grEdgeArr[currEdge].gcell1) {
+            segments.push_back(make_pair(startPt, endPt));
+            startPt = *grEdgeArr[currEdge].gcell1;
+            endPt = *grEdgeArr[currEdge].gcell2;
+        } else {
+            endPt = *grEdgeArr[currEdge].gcell2;
+        }
     }
+    segments.push_back(make_pair(startPt, endPt));
+}
 
-    cout << "Writing `" << filename << "' ..." << flush;
+//@brief: append the edges of a solution segment between two points in design
+//        coordinates (layers counted from 1). False, leaving `edges` as it was, if the
+//        segment is not a straight run of existing edges.
+bool SimpleGR::segmentEdges(const double from[3], const double to[3], std::vector<IdType> &edges) const
+{
+    using namespace std;
+
+    long cell[2][3];
+    for (int end = 0; end < 2; ++end) {
+        const double *p = end == 0 ? from : to;
+        if (!isfinite(p[0]) || !isfinite(p[1]) || !isfinite(p[2])) { return false; }
+        cell[end][0] = lround(floor((p[0] - minX) / gcellWidth));
+        cell[end][1] = lround(floor((p[1] - minY) / gcellHeight));
+        cell[end][2] = lround(p[2]) - 1;
+        if (cell[end][0] < 0 || cell[end][0] >= static_cast<long>(gcellArrSzX) || cell[end][1] < 0
+            || cell[end][1] >= static_cast<long>(gcellArrSzY) || cell[end][2] < 0
+            || cell[end][2] >= static_cast<long>(numLayers)) {
+            return false;
+        }
+    }
+    if ((cell[0][0] != cell[1][0]) + (cell[0][1] != cell[1][1]) + (cell[0][2] != cell[1][2]) > 1) { return false; }
+    const Point a(static_cast<CoordType>(cell[0][0]), static_cast<CoordType>(cell[0][1]), static_cast<CoordType>(cell[0][2]));
+    const Point b(static_cast<CoordType>(cell[1][0]), static_cast<CoordType>(cell[1][1]), static_cast<CoordType>(cell[1][2]));
+
+    const size_t size = edges.size();
+    for (CoordType j = min(a.x, b.x); j < max(a.x, b.x); ++j) { edges.push_back(gcellArr3D[a.z][a.y][j].incX); }
+    for (CoordType j = min(a.y, b.y); j < max(a.y, b.y); ++j) { edges.push_back(gcellArr3D[a.z][j][a.x].incY); }
+    for (CoordType j = min(a.z, b.z); j < max(a.z, b.z); ++j) { edges.push_back(gcellArr3D[j][a.y][a.x].incZ); }
+    if (find(edges.begin() + static_cast<ptrdiff_t>(size), edges.end(), NULLID) != edges.end()) {
+        edges.resize(size);
+        return false;
+    }
+    return true;
+}
+
+//@brief: whether `edges` (sorted, without repeats) connect the pins of `net`, by
+//        union-find over the gcells they touch. With `noStubs` the route must also end
+//        at no gcell but the pins.
+bool SimpleGR::routeConnects(const Net &net, const std::vector<IdType> &edges, bool noStubs, RouteScratch &scratch) const
+{
+    using namespace std;
+
+    vector<IdType> &ends = scratch.ends, &cells = scratch.cells, &parent = scratch.parent, &degree = scratch.degree;
+    auto cellOf = [&](const Point &p) { return gcellCoordToId(p.x, p.y, p.z); };
+
+    // the gcells at both ends of every edge, looked up once
+    ends.clear();
+    for (const IdType e : edges) {
+        ends.push_back(cellOf(*grEdgeArr[e].gcell1));
+        ends.push_back(cellOf(*grEdgeArr[e].gcell2));
+    }
+    cells.assign(ends.begin(), ends.end());
+    sort(cells.begin(), cells.end());
+    cells.erase(unique(cells.begin(), cells.end()), cells.end());
+    auto indexOf = [&](IdType gcellId) {
+        return static_cast<IdType>(lower_bound(cells.begin(), cells.end(), gcellId) - cells.begin());
+    };
+    auto root = [&](IdType i) {
+        while (parent[i] != i) { i = parent[i] = parent[parent[i]]; }
+        return i;
+    };
+    parent.resize(cells.size());
+    degree.assign(cells.size(), 0);
+    for (IdType i = 0; i < cells.size(); ++i) { parent[i] = i; }
+    for (size_t k = 0; k < ends.size(); k += 2) {
+        const IdType a = indexOf(ends[k]), b = indexOf(ends[k + 1]);
+        parent[root(a)] = root(b);
+        ++degree[a], ++degree[b];
+    }
+    const IdType one = indexOf(cellOf(net.gCellOne)), two = indexOf(cellOf(net.gCellTwo));
+    if (one >= cells.size() || cells[one] != cellOf(net.gCellOne) || two >= cells.size()
+        || cells[two] != cellOf(net.gCellTwo) || root(one) != root(two)) {
+        return false;
+    }
+    for (IdType i = 0; noStubs && i < cells.size(); ++i) {
+        if (degree[i] == 1 && i != one && i != two) { return false; }
+    }
+    return true;
+}
+
+//@brief: keep the routes of a previous solution (-warmStart) for the nets they still
+//        fit: a route is kept only if every segment lies on an existing edge and the
+//        edges connect the net's current pins. Nets of the solution no longer in the
+//        design are ignored; new nets and nets whose route was dropped stay unrouted
+//        for initial routing to route. False if the solution cannot be opened.
+bool SimpleGR::warmStart(void)
+{
+    using namespace std;
+
+    GR_PROFILE_PHASE("warmStart");
+
+    ifstream infile(params.warmStartFile.c_str());
+    if (!infile.good()) { return parseFailed("could not open `" + params.warmStartFile + "' for reading"); }
+    cout << "Reading prior routes from `" << params.warmStartFile << "' ..." << endl;
+
+    priorRoute.assign(grNetArr.size(), 0);
+    unsigned kept = 0, dropped = 0, unknown = 0;
+
+    string netname, restofline;
+    vector<IdType> edges;
+    RouteScratch scratch;
+    while (infile >> netname) {
+        getline(infile, restofline);
+
+        // the segments, as (x,y,z)-(x,y,z) in design coordinates with layers from 1
+        bool legal = true;
+        edges.clear();
+        while (infile.peek() == '(') {
+            double x1, y1, z1, x2, y2, z2;
+            char junk;
+            infile >> junk >> x1 >> junk >> y1 >> junk >> z1 >> junk >> junk >> junk >> x2 >> junk >> y2 >> junk >> z2;
+            getline(infile, restofline);
+            const double from[3] = { x1, y1, z1 }, to[3] = { x2, y2, z2 };
+            legal = legal && infile.good() && segmentEdges(from, to, edges);
+        }
+        getline(infile, restofline);// the trailing !
+
+        IdType netId;
+        if (!netNames.find(netname, netId) || netId == NULLID || grNetArr[netId].routed) {
+            ++unknown;
+            continue;
+        }
+        Net &net = grNetArr[netId];
+        sort(edges.begin(), edges.end());
+        edges.erase(unique(edges.begin(), edges.end()), edges.end());
+
+        // the route must connect the pins and end nowhere else (a pin moved along the
+        // route leaves a dangling stub)
+        if (!legal || !routeConnects(net, edges, true, scratch)) {
+            ++dropped;
+            continue;
+        }
+
+        for (const IdType e : edges) { addSegment(net, grEdgeArr[e]); }
+        net.routed = true;
+        priorRoute[net.id] = 1;
+        ++kept;
+    }
+
+    runReport.priorRoutesKept = kept;
+    cout << "kept the prior routes of " << kept << " GR nets, dropped " << dropped << " that no longer fit";
+    if (unknown > 0) { cout << ", ignored " << unknown << " nets not in the design"; }
+    cout << endl;
+    cout << grNetArr.size() - kept << " GR nets left to route" << endl;
+    return true;
+}
+
+void SimpleGR::writeSolution(std::ostream &outfile) const
+{
+    using namespace std;
 
+    vector<pair<Point, Point>> segments;
     for (unsigned i = 0; i < grNetArr.size(); ++i) {
         bool netRouted = grNetArr[i].routed;
 
         if (netRouted) {
-            vector<unsigned> usedEdges(grNetArr[i].segments);
-
-            sort(usedEdges.begin(), usedEdges.end());
-
-            vector<pair<Point, Point>> segments;
-
-            // add routed segments
-            assert(usedEdges.size() > 0);
-            Point startPt(*grEdgeArr[usedEdges[0]].gcell1);
-            Point endPt(*grEdgeArr[usedEdges[0]].gcell2);
-            for (unsigned j = 1; j < usedEdges.size(); ++j) {
-                unsigned prevEdge = usedEdges[j - 1];
-                unsigned currEdge = usedEdges[j];
-
-                if (grEdgeArr[prevEdge].type != grEdgeArr[currEdge].type
-                    || grEdgeArr[prevEdge].gcell2 != grEdgeArr[currEdge].gcell1) {
-                    segments.push_back(make_pair(startPt, endPt));
-                    startPt = *grEdgeArr[currEdge].gcell1;
-                    endPt = *grEdgeArr[currEdge].gcell2;
-                } else {
-                    endPt = *grEdgeArr[currEdge].gcell2;
-                }
-            }
-            segments.push_back(make_pair(startPt, endPt));
+            netSegments(i, segments);
 
-            outfile << netNameArr[i] << " " << netDBIdArr[i] << " " << segments.size() << endl;
+            outfile << netNames.name(i) << " " << netDBIdArr[i] << " " << segments.size() << endl;
             for (unsigned j = 0; j < segments.size(); ++j) {
                 outfile << "(" << minX + gcellWidth * static_cast<double>(segments[j].first.x) + halfWidth << ","
                         << minY + gcellHeight * static_cast<double>(segments[j].first.y) + halfHeight;
@@ -568,211 +760,26 @@ void SimpleGR::writeRoutes()
             outfile << "!" << endl;
         }
     }
-
-    cout << " done" << endl;
 }
 
-const char *coolMap[] = {
-    /* columns rows colors chars-per-pixel */
-    "a c #ffffff",
-    "b c #00009f",
-    "c c #0000af",
-    "d c #0000bf",
-    "e c #0000cf",
-    "f c #0000df",
-    "g c #0000ef",
-    "h c #0000ff",
-    "i c #000fff",
-    "j c #001fff",
-    "k c #002fff",
-    "l c #003fff",
-    "m c #004fff",
-    "n c #005fff",
-    "o c #006fff",
-    "p c #007fff",
-    "q c #008fff",
-    "r c #009fff",
-    "s c #00afff",
-    "t c #00bfff",
-    "u c #00cfff",
-    "v c #00dfff",
-    "w c #00efff",
-    "x c #00ffff",
-    "y c #0fffef",
-    "z c #1fffdf",
-    "A c #2fffcf",
-    "B c #3fffbf",
-    "C c #4fffaf",
-    "D c #5fff9f",
-    "E c #6fff8f",
-    "F c #7fff7f",
-    "G c #8fff6f",
-    "H c #9fff5f",
-    "I c #afff4f",
-    "J c #bfff3f",
-    "K c #cfff2f",
-    "L c #dfff1f",
-    "M c #efff0f",
-    "N c #ffff00",
-    "O c #ffef00",
-    "P c #ffdf00",
-    "Q c #ffcf00",
-    "R c #ffbf00",
-    "S c #ffaf00",
-    "T c #ff9f00",
-    "U c #ff8f00",
-    "V c #ff7f00",
-    "W c #ff6f00",
-    "X c #ff5f00",
-    "Y c #ff4f00",
-    "Z c #ff3f00",
-    "0 c #ff2f00",
-    "1 c #ff1f00",
-    "2 c #ff0f00",
-    "3 c #ff0000",
-    "4 c #ef0000",
-    "5 c #df0000",
-    "6 c #cf0000",
-    "7 c #bf0000",
-    "8 c #af0000",
-    "9 c #9f0000",
-    ", c #8f0000",
-    ". c #7f0000"
-};
-
-const char *Colors[] = { "a",
-    "b",
-    "c",
-    "d",
-    "e",
-    "f",
-    "g",
-    "h",
-    "i",
-    "j",
-    "k",
-    "l",
-    "m",
-    "n",
-    "o",
-    "p",
-    "q",
-    "r",
-    "s",
-    "t",
-    "u",
-    "v",
-    "w",
-    "x",
-    "y",
-    "z",
-    "A",
-    "B",
-    "C",
-    "D",
-    "E",
-    "F",
-    "G",
-    "H",
-    "I",
-    "J",
-    "K",
-    "L",
-    "M",
-    "N",
-    "O",
-    "P",
-    "Q",
-    "R",
-    "S",
-    "T",
-    "U",
-    "V",
-    "W",
-    "X",
-    "Y",
-    "Z",
-    "0",
-    "1",
-    "2",
-    "3",
-    "4",
-    "5",
-    "6",
-    "7",
-    "8",
-    "9",
-    ",",
-    "." };
-
-void SimpleGR::plotXPM(const std::string &filename)
+void SimpleGR::writeRoutes()
 {
     using namespace std;
 
-    const unsigned numColors = 64;
-
-    string fullfilename = filename + string(".xpm");
-
-    ofstream xpmFile(fullfilename.c_str());
-
-    xpmFile << "/* XPM */" << endl;
-    xpmFile << "static char *congestion[] = {" << endl;
-    xpmFile << "/* columns rows colors chars-per-pixel */" << endl;
-    xpmFile << "\"" << gcellArrSzX - 1 << " " << gcellArrSzY - 1 << " " << numColors << " 1\"," << endl;
-    for (unsigned i = 0; i < numColors; ++i) xpmFile << "\"" << coolMap[i] << "\"," << endl;
-    xpmFile << "/* pixels */" << endl;
-
-    vector<vector<double>> image;
-
-    double maxRatio = 1.;
-
-    for (unsigned rj = 2; rj <= gcellArrSzY; ++rj) {
-        unsigned j = gcellArrSzY - rj;
-        vector<double> horizLine;
-        for (unsigned i = 0; i < gcellArrSzX - 1; ++i) {
-            double xUsage = 0., xCap = 0., yUsage = 0., yCap = 0.;
-            for (unsigned k = 0; k < gcellArr3D.size(); ++k) {
-                unsigned xEdgeId = gcellArr3D[k][j][i].incX;
-                unsigned yEdgeId = gcellArr3D[k][j][i].incY;
-
-                if (xEdgeId != UINT_MAX) {
-                    xUsage += grEdgeArr[xEdgeId].usage;
-                    xCap += grEdgeArr[xEdgeId].capacity;
-                }
-                if (yEdgeId != UINT_MAX) {
-                    yUsage += grEdgeArr[yEdgeId].usage;
-                    yCap += grEdgeArr[yEdgeId].capacity;
-                }
-            }
-
-            double xRatio = static_cast<double>(xUsage) / static_cast<double>(xCap);
-            double yRatio = static_cast<double>(yUsage) / static_cast<double>(yCap);
-
-            double totalRatio = 0.5 * (xRatio + yRatio);
+    GR_PROFILE_PHASE("writeRoutes");
 
-            maxRatio = max(maxRatio, totalRatio);
+    if (params.outputFile.empty()) { return; }
+    const ScopedPhase phase(runReport, "writeRoutes");
+    string filename = params.outputFile;
+    ofstream outfile(filename.c_str());
 
-            horizLine.push_back(totalRatio);
-        }
-        image.push_back(horizLine);
+    if (!outfile.good()) {
+        cout << "Could not open `" << filename << "' for writing." << endl;
+        return;
     }
 
-    cout << "maxratio was " << maxRatio << endl;
-
-    for (unsigned j = 0; j < gcellArrSzY - 1; ++j) {
-        xpmFile << "\"";
-        for (unsigned i = 0; i < gcellArrSzX - 1; ++i) {
-            unsigned index =
-                static_cast<unsigned>(floor((image[j][i] / maxRatio) * static_cast<double>(numColors - 1)));
+    cout << "Writing `" << filename << "' ..." << flush;
+    writeSolution(outfile);
 
-            xpmFile << Colors[index];
-        }
-        if (j == gcellArrSzY - 2) {
-            xpmFile << "\"" << endl;
-        } else {
-            xpmFile << "\"," << endl;
-        }
-    }
-    xpmFile << ");" << endl;
-    xpmFile.close();
+    cout << " done" << endl;
 }
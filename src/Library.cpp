@@ -0,0 +1,114 @@
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "SimpleGR.h"
+
+thread_local std::streambuf *ThreadLogBuf::target = nullptr;
+
+//@brief: run the three phases on the design parsed last, calling the progress callback
+//        at the end of each phase and after each rip-up and re-route iteration. False if
+//        the checkpoint or prior solution to start from could not be read, with the reason
+//        in parseError().
+bool SimpleGR::route(void)
+{
+    stopRequested = false;
+    if (!initialRouting()) { return false; }
+    doRRR();
+    greedyImprovement();
+    return true;
+}
+
+//@brief: totals of the current routing; without `checkRouted` every GR net counts as
+//        routed, as for a solution read with parseSolution
+RouteStatistics SimpleGR::statistics(bool checkRouted) const
+{
+    RouteStatistics stats;
+    for (unsigned i = 0; i < grEdgeArr.size(); ++i) {
+        stats.maxOverflow = std::max(stats.maxOverflow, grEdgeArr[i].usage - grEdgeArr[i].capacity);
+    }
+    for (unsigned i = 0; i < grNetArr.size(); ++i) {
+        if (!checkRouted || grNetArr[i].routed) {
+            ++stats.netsRouted;
+            stats.vias += grNetArr[i].numVias;
+            stats.routedLength += grNetArr[i].numSegments;
+        }
+    }
+    stats.routableNets = routableNets;
+    stats.wireLength = static_cast<CostType>(stats.routedLength) + viaFactor * static_cast<CostType>(stats.vias);
+    stats.overfullEdges = overfullEdges;
+    stats.totalOverflow = totalOverflow;
+    stats.cpuSeconds = cpuTime();
+    return stats;
+}
+
+//@brief: the routes of the routed GR nets, with the segments writeRoutes would write
+std::vector<NetRoute> SimpleGR::routes(void) const
+{
+    using namespace std;
+
+    vector<NetRoute> result;
+    vector<pair<Point, Point>> segments;
+    for (IdType i = 0; i < grNetArr.size(); ++i) {
+        if (!grNetArr[i].routed) { continue; }
+        netSegments(i, segments);
+
+        NetRoute route;
+        route.name = netNames.name(i);
+        route.dbId = netDBIdArr[i];
+        route.segments.reserve(segments.size());
+        for (const pair<Point, Point> &segment : segments) {
+            RouteSegment piece;
+            piece.x1 = minX + gcellWidth * static_cast<double>(segment.first.x) + halfWidth;
+            piece.y1 = minY + gcellHeight * static_cast<double>(segment.first.y) + halfHeight;
+            piece.z1 = segment.first.z + 1;
+            piece.x2 = minX + gcellWidth * static_cast<double>(segment.second.x) + halfWidth;
+            piece.y2 = minY + gcellHeight * static_cast<double>(segment.second.y) + halfHeight;
+            piece.z2 = segment.second.z + 1;
+            route.segments.push_back(piece);
+        }
+        result.push_back(std::move(route));
+    }
+    return result;
+}
+
+//@brief: call the progress callback, if any; from then on timeUp holds if it returns false
+void SimpleGR::reportProgress(const char *phase, unsigned iteration)
+{
+    if (!progress) { return; }
+    RouteProgress status;
+    status.phase = phase;
+    status.iteration = iteration;
+    status.statistics = statistics();
+    if (!progress(status)) {
+        std::cout << "Stopped by the progress callback after " << phase << std::endl;
+        stopRequested = true;
+    }
+}
+
+void SimpleGR::adoptBuffers(RouterBuffers &buffers)
+{
+    gcellArr3D.swap(buffers.gcells);
+    grEdgeArr.swap(buffers.edges);
+    grEdgeArr.clear();
+    std::swap(priorityQueue, buffers.queue);
+    priorityQueue.clear();
+    workerQueues.swap(buffers.workerQueues);
+    for (PQueue &queue : workerQueues) { queue.clear(); }
+    std::swap(wavefrontScratch, buffers.wavefrontScratch);
+    workerScratch.swap(buffers.workerScratch);
+    std::swap(deltaScratch, buffers.deltaScratch);
+}
+
+void SimpleGR::releaseBuffers(RouterBuffers &buffers)
+{
+    // the scratch is all zero between searches, as the next design expects it
+    buffers.gcells.swap(gcellArr3D);
+    buffers.edges.swap(grEdgeArr);
+    std::swap(buffers.queue, priorityQueue);
+    buffers.workerQueues.swap(workerQueues);
+    std::swap(buffers.wavefrontScratch, wavefrontScratch);
+    buffers.workerScratch.swap(workerScratch);
+    std::swap(buffers.deltaScratch, deltaScratch);
+}
@@ -3,22 +3,36 @@
  * Work on this file to complete your maze router
  */
 
+#include "Profiler.h"
 #include "SimpleGR.h"
 
+thread_local unsigned SimpleGR::searchWorker = 0;
+thread_local bool SimpleGR::searchShared = false;
+
 ///////////////////////////////////////////////////////////////////////////////
 // Implement an A* search based maze routing algorithm
 // and a corresponding back-trace procedure
 // The function needs to correctly deal with the following conditions:
 // 1. Only search within a bounding box defined by botleft and topright points
 // 2. Control if any overflow on the path is allowed or not
+//
+// `stats` collects per-call telemetry. With NoSearchStats every call on it is
+// empty and inlined away, so the search pays nothing when telemetry is off.
+// The cost function and the overflow policy are template parameters as well,
+// routeNet picks the instantiation once per net.
 ///////////////////////////////////////////////////////////////////////////////
+template<typename Cost, bool AllowOverflow, typename Stats>
 CostType SimpleGR::routeMaze(Net &net,
-    bool allow_overflow,
     const Point &bot_left,
     const Point &top_right,
-    const EdgeCost &edge_cost,
-    std::vector<Edge *> &path)
+    Cost edge_cost,
+    std::vector<Edge *> &path,
+    Stats &stats)
 {
+    GR_PROFILE_SCOPE("routeMaze");
+
+    stats.begin();
+
     // Get the ID of the source and destination cells
     const IdType source_cell_id = getGCellId(net.gCellOne);
     const IdType dest_cell_id = getGCellId(net.gCellTwo);
@@ -27,13 +41,41 @@ CostType SimpleGR::routeMaze(Net &net,
     // about the source cell)
     const auto &dest_cell = getGCell(dest_cell_id);
 
+    // the pins lie in different connected regions (of the edges with room, when
+    // overflow is not allowed), nothing to search
+    // parallel searches each have their own queue and bound, and leave the cache and
+    // the components alone
+    const bool parallel = searchShared;
+    GCellComponents &components = AllowOverflow ? gridComponents : freeComponents;
+    if (parallel ? !components.connectedShared(source_cell_id, dest_cell_id)
+                 : !components.connected(source_cell_id, dest_cell_id)) {
+        stats.end();
+        return std::numeric_limits<CostType>::max();
+    }
+
+    //@brief lower bound on the cost from a cell to the destination under `edge_cost`,
+    //  the A* heuristic. The `PathLowerBound` class is defined in SimpleGR.h
+    const PathLowerBound &heuristic = pathBound(edge_cost);
+
+    PQueue &queue = searchQueue();
+    SearchBound &bound = searchWorker > 0 ? workerBounds[searchWorker - 1] : searchBound;
+
+    // the same search ran before and nothing it looked at has changed since
+    const RouteCache::Key cache_key{ source_cell_id, dest_cell_id, bot_left, top_right, Cost::kind, AllowOverflow };
+    const bool cached = routeCache.enabled() && !parallel;
+    if (cached) {
+        if (const RouteCache::Entry *hit = routeCache.find(cache_key, heuristic.epoch(), searchWeight)) {
+            path.clear();
+            for (const IdType id : hit->path) { path.push_back(&grEdgeArr[id]); }
+            if (hit->bound > 0.f) { bound.add(hit->cost, hit->bound); }
+            stats.end();
+            return hit->cost;
+        }
+    }
+
     // the priority queue keeps track of which cells are visited
     // insert the source cell to the priority queue to indicate that it has been visited
-    priorityQueue.setGCellCost(source_cell_id, 0., 0., NULLID);
-
-    //@brief calculates the manhattan distance between two cells
-    //  The `ManhattanCost` function object is defined in SimpleGR.h
-    ManhattanCost &manhattanDistance = ManhattanCost::getFunc();
+    queue.setGCellCost(source_cell_id, 0., 0., NULLID);
 
     //@brief checks if a cell is in the bounding box
     //  Note: this function ignores the z-boundary, as when `routeMaze` is called
@@ -68,6 +110,244 @@ CostType SimpleGR::routeMaze(Net &net,
     //  that it will be inlined at compile time
     auto reached_destination = [&dest_cell_id](const IdType &cellId) { return dest_cell_id == cellId; };
 
+    //@brief Checks if traversing an edge will cause overflow
+    auto causes_overflow = [this](const IdType edge_id) -> bool {
+        if constexpr (AllowOverflow) {
+            static_cast<void>(edge_id);
+            return false;
+        }
+
+        return !edgeHasRoom(grEdgeArr[edge_id]);
+    };
+
+    // weighted A*: the heuristic is inflated by `weight` (>= 1), which bounds the route
+    // cost by weight times the optimum. Closed gcells are never reopened.
+    const CostType weight = searchWeight;
+    // lower bound contributed by closed gcells that were reached again on a cheaper path
+    CostType reopenBound = std::numeric_limits<CostType>::max();
+
+    // with a -deadline, the search gives up once it passes, checked every 1024 expansions
+    const bool abortable = searchDeadline;
+    unsigned expansions = 0;
+    bool aborted = false;
+
+    // A* search algorithm
+    //
+    // The *best* cell in the priority queue is determined by the cell's "total cost", which
+    // is calculated by summing the distance from source cell to the cell with the the (weighted)
+    // manhattan distance from the cell to the destination cell.
+    //
+    // In a tradiional A* search you would only insert the single next best location from the
+    // current location, but this implmentation inserts all the next possible locations from
+    // current location
+    do {
+        const auto this_cell_id = queue.getBestGCell();
+        const auto this_cell_data = queue.getGCellData(this_cell_id);
+
+        queue.rmBestGCell();
+        stats.expand();
+
+        // if the current cell is the dest cell we can pop out of this loop
+        if (reached_destination(this_cell_id)) { break; }
+
+        if (abortable && (++expansions & 1023U) == 0 && timeUp()) {
+            aborted = true;
+            break;
+        }
+
+        // get all the edges from the current cell in order to look at the
+        // next possible cells
+        auto edges = getGCellEdges(this_cell_id);
+
+        for (const auto &edgeId : edges) {
+
+            if (causes_overflow(edgeId)) { continue; }
+
+            // get references to the cell connected to the current cell by the current edge
+            const auto &this_cell = getGCell(this_cell_id);
+            const GCell &connecting_cell = get_connecting_cell(this_cell, edgeId);
+
+            // if the cell is out of the bounding box we can skip this loop
+            if (!in_bounding_box(connecting_cell)) { continue; }
+
+            // calculate the two types of cost
+            // manh_cost : heuristic cost between the connecting cell and the destination
+            // path_cost : the cost from the source cell to the connecting cell
+            const auto manh_cost = heuristic(connecting_cell, dest_cell);
+            const auto path_cost = edge_cost(edgeId) + this_cell_data.pathCost;
+
+            // Calculate the total cost as detailed in the PQueue.setGCellCost function
+            const auto total_cost = path_cost + weight * manh_cost;
+
+            // get the connecting cell id to insert it into the priority queue
+            const auto connecting_cell_id = getGCellId(connecting_cell);
+
+            // insert the neighbor cell into the priority queue
+            if (!queue.isGCellVsted(connecting_cell_id)) {
+                queue.setGCellCost(connecting_cell_id, total_cost, path_cost, this_cell_id);
+                stats.relax(queue.size());
+            } else if (queue.getGCellData(connecting_cell_id).pathCost > path_cost) {
+                if (queue.isGCellQueued(connecting_cell_id)) {
+                    queue.setGCellCost(connecting_cell_id, total_cost, path_cost, this_cell_id);
+                    stats.relax(queue.size());
+                } else {
+                    // only possible with an inflated heuristic
+                    reopenBound = std::min(reopenBound, path_cost + manh_cost);
+                }
+            }
+        }
+
+    } while (!queue.isEmpty());
+
+    // an aborted search may have queued the destination without settling it
+    const bool found = !aborted && queue.isGCellVsted(dest_cell_id);
+
+    // now backtrace and build up the path, if we found one
+    if (found) { tracePath(source_cell_id, dest_cell_id, path); }
+
+    // an unconstrained search that failed has visited the whole component of the source
+    const bool unconstrained = bot_left.x == 0 && bot_left.y == 0 && top_right.x + 1 >= gcellArrSzX
+                               && top_right.y + 1 >= gcellArrSzY;
+    if (!found && !aborted && unconstrained && !parallel) { components.split(queue.getVisitedGCells()); }
+
+    // calculate the accumulated cost of the path
+    const CostType finalCost = found ? queue.getGCellData(dest_cell_id).pathCost : std::numeric_limits<CostType>::max();
+
+    // With weight > 1 the optimum is bounded from below by cost / weight, and by the
+    // smallest unweighted f left in the queue and among the closed gcells that were
+    // not reopened. The tighter one gives the suboptimality this search actually
+    // achieved (ARA*'s bound).
+    CostType achievedBound = 0.f;
+    if (weight > 1.f && found) {
+        CostType lowerBound = std::min(finalCost, reopenBound);
+        for (const IdType id : queue.getQueuedGCells()) {
+            lowerBound =
+                std::min(lowerBound, queue.getGCellData(id).pathCost + heuristic(getGCell(id), dest_cell));
+        }
+        achievedBound = std::max(lowerBound, finalCost / weight);
+        bound.add(finalCost, achievedBound);
+    }
+
+    // remember the result with the tiles around every gcell the search touched; the
+    // edges of a gcell belong to it or to its lower neighbors, hence the margin
+    if (cached && !aborted) {
+        RouteCache::Entry entry;
+        entry.path.reserve(path.size());
+        for (const Edge *edge : path) { entry.path.push_back(edge->id); }
+        entry.cost = finalCost;
+        entry.bound = achievedBound;
+        entry.boundEpoch = heuristic.epoch();
+        entry.weight = weight;
+        entry.usageFree = Cost::usageFree;
+
+        CoordType loX = gcellArrSzX, loY = gcellArrSzY, hiX = 0, hiY = 0;
+        for (const IdType id : queue.getVisitedGCells()) {
+            const GCell &cell = getGCell(id);
+            loX = std::min(loX, cell.x);
+            loY = std::min(loY, cell.y);
+            hiX = std::max(hiX, cell.x);
+            hiY = std::max(hiY, cell.y);
+        }
+        entry.tileLo = Point((loX > 0 ? loX - 1 : 0) / RouteCache::tileSize, (loY > 0 ? loY - 1 : 0) / RouteCache::tileSize, 0);
+        entry.tileHi = Point(std::min(hiX + 1, gcellArrSzX - 1) / RouteCache::tileSize,
+            std::min(hiY + 1, gcellArrSzY - 1) / RouteCache::tileSize,
+            0);
+        routeCache.store(cache_key, std::move(entry));
+    }
+
+    // clean up
+    queue.clear();
+
+    stats.end();
+
+    return finalCost;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Shortest-path tree search for a group of nets that share a pin gcell: one
+// Dijkstra expansion from `source_cell_id` that keeps settling targets until
+// every one of them is reached, instead of one A* search per net. `paths[i]` and
+// `costs[i]` receive the route to `target_cells[i]`; an empty path means the
+// target is unreachable within the box.
+///////////////////////////////////////////////////////////////////////////////
+template<typename Cost, bool AllowOverflow>
+void SimpleGR::routeTree(IdType source_cell_id,
+    const std::vector<IdType> &target_cells,
+    const Point &bot_left,
+    const Point &top_right,
+    Cost edge_cost,
+    std::vector<std::vector<Edge *>> &paths,
+    std::vector<CostType> &costs)
+{
+    GR_PROFILE_SCOPE("routeTree");
+
+    GCellComponents &components = AllowOverflow ? gridComponents : freeComponents;
+
+    // the distinct targets that can be reached at all, settled ones are erased
+    std::vector<IdType> pending;
+    for (const IdType id : target_cells) {
+        if (components.connected(source_cell_id, id)) { pending.push_back(id); }
+    }
+    std::sort(pending.begin(), pending.end());
+    pending.erase(std::unique(pending.begin(), pending.end()), pending.end());
+
+    auto in_bounding_box = [&bot_left, &top_right](const Point &cell) {
+        return (bot_left.x <= cell.x && cell.x <= top_right.x) && (bot_left.y <= cell.y && cell.y <= top_right.y);
+    };
+
+    priorityQueue.setGCellCost(source_cell_id, 0., 0., NULLID);
+    while (!pending.empty() && !priorityQueue.isEmpty()) {
+        const IdType this_cell_id = priorityQueue.getBestGCell();
+        const CostType this_path_cost = priorityQueue.getGCellData(this_cell_id).pathCost;
+        priorityQueue.rmBestGCell();
+
+        // a settled target has its final cost
+        const auto settled = std::lower_bound(pending.begin(), pending.end(), this_cell_id);
+        if (settled != pending.end() && *settled == this_cell_id) {
+            pending.erase(settled);
+            if (pending.empty()) { break; }
+        }
+
+        const GCell &this_cell = getGCell(this_cell_id);
+        for (const IdType edgeId : getGCellEdges(this_cell)) {
+            const Edge &edge = grEdgeArr[edgeId];
+            if (!AllowOverflow && !edgeHasRoom(edge)) { continue; }
+
+            const GCell &next_cell = edge.gcell1 == &this_cell ? *edge.gcell2 : *edge.gcell1;
+            if (!in_bounding_box(next_cell)) { continue; }
+
+            const IdType next_cell_id = getGCellId(next_cell);
+            const CostType path_cost = this_path_cost + edge_cost(edgeId);
+            if (!priorityQueue.isGCellVsted(next_cell_id)
+                || (priorityQueue.isGCellQueued(next_cell_id)
+                    && priorityQueue.getGCellData(next_cell_id).pathCost > path_cost)) {
+                priorityQueue.setGCellCost(next_cell_id, path_cost, path_cost, this_cell_id);
+            }
+        }
+    }
+
+    paths.resize(target_cells.size());
+    costs.resize(target_cells.size());
+    for (std::size_t i = 0; i < target_cells.size(); ++i) {
+        const IdType target = target_cells[i];
+        paths[i].clear();
+        costs[i] = std::numeric_limits<CostType>::max();
+        // a target still pending was reached but not settled, its cost is not final
+        if (!priorityQueue.isGCellVsted(target) || std::binary_search(pending.begin(), pending.end(), target)) {
+            continue;
+        }
+        if (target != source_cell_id) { tracePath(source_cell_id, target, paths[i]); }
+        costs[i] = priorityQueue.getGCellData(target).pathCost;
+    }
+
+    priorityQueue.clear();
+}
+
+//@brief: back-track from `dest_cell_id` to `source_cell_id` through the parents the
+//        last search left in the priority queue, and fill up 'path' with all the
+//        edges that are traversed
+void SimpleGR::tracePath(IdType source_cell_id, IdType dest_cell_id, std::vector<Edge *> &path)
+{
     //@brief Given two cells that are adjacent to one other, return a reference to
     //  the edge between the cells.
     auto get_edge = [this](const IdType cell1_id, const IdType cell2_id) -> Edge & {
@@ -104,108 +384,691 @@ CostType SimpleGR::routeMaze(Net &net,
         return edge;
     };
 
-    //@brief Checks if traversing an edge will cause overflow
-    auto causes_overflow = [this, &allow_overflow](const IdType edge_id) -> bool {
-        if (allow_overflow) { return false; }
+    const PQueue &queue = searchQueue();
+    auto current_id = dest_cell_id;
 
-        const auto &edge = grEdgeArr[edge_id];
-        const CapType demand = (edge.type == VIA) ? 0 : minWidths[edge.layer] + minSpacings[edge.layer];
+    // pre-allocate estimated space for the route path in order to minimize allocations
+    {
+        const auto estimated_size = ManhattanCost::getFunc()(getGCell(source_cell_id), getGCell(dest_cell_id));
+        path.reserve(static_cast<std::size_t>(estimated_size) * 2);
+    }
 
-        const auto will_overflow = (edge.usage + demand) > edge.capacity;
+    // clear the path in case it was already used
+    path.clear();
 
-        return will_overflow;
-    };
+    while (current_id != source_cell_id) {
+        const auto &current_node = queue.getGCellData(current_id);
+        const auto parent_id = current_node.parentGCell;
 
-    // A* search algorithm
-    //
-    // The *best* cell in the priority queue is determined by the cell's "total cost", which
-    // is calculated by summing the distance from source cell to the cell with the the manhattan
-    // distance from the cell to the destination cell.
-    //
-    // In a tradiional A* search you would only insert the single next best location from the
-    // current location, but this implmentation inserts all the next possible locations from
-    // current location
-    do {
-        const auto this_cell_id = priorityQueue.getBestGCell();
-        const auto this_cell_data = priorityQueue.getGCellData(this_cell_id);
+        auto &edge = get_edge(current_id, parent_id);
+        path.push_back(&edge);// this vector expects a pointer, for some reason
 
-        priorityQueue.rmBestGCell();
+        current_id = parent_id;
+    }
+}
 
-        // if the current cell is the dest cell we can pop out of this loop
-        if (reached_destination(this_cell_id)) { break; }
+//@brief: recompute the DLM heuristic from the current history costs and usage.
+//        The bound stays admissible while only the nets in `netsToReroute` are ripped
+//        up: their demand is taken off every edge they use, and routing only adds
+//        usage. Costs O(edges + segments of those nets).
+void SimpleGR::refreshDLMBound(const std::vector<IdType> &netsToReroute)
+{
+    GR_PROFILE_SCOPE("refreshDLMBound");
 
-        // get all the edges from the current cell in order to look at the
-        // next possible cells
-        auto edges = getGCellEdges(this_cell_id);
+    const DLMEdgeCost dlm(*this);
 
-        for (const auto &edgeId : edges) {
+    std::vector<char> rerouted(grNetArr.size(), 0);
+    for (const IdType netId : netsToReroute) { rerouted[netId] = 1; }
 
-            if (causes_overflow(edgeId)) { continue; }
+    std::vector<CostType> colCost(gcellArrSzX - 1, std::numeric_limits<CostType>::max());
+    std::vector<CostType> rowCost(gcellArrSzY - 1, std::numeric_limits<CostType>::max());
+    for (IdType i = 0; i < nonViaEdges; ++i) {
+        const Edge &edge = grEdgeArr[i];
+        const CapType demand = minWidths[edge.layer] + minSpacings[edge.layer];
 
-            // get references to the cell connected to the current cell by the current edge
-            const auto &this_cell = getGCell(this_cell_id);
-            const GCell &connecting_cell = get_connecting_cell(this_cell, edgeId);
-
-            // if the cell is out of the bounding box we can skip this loop
-            if (!in_bounding_box(connecting_cell)) { continue; }
+        CapType minUsage = edge.usage;
+        for (const IdType netId : edge.nets) {
+            if (rerouted[netId]) { minUsage -= std::min(minUsage, demand); }
+        }
 
-            // calculate the two types of cost
-            // manh_cost : heuristic cost between the connecting cell and the destination
-            // edge_cost : the cost from the source cell to the connecting cell
-            const auto manh_cost = manhattanDistance(connecting_cell, dest_cell);
-            const auto path_cost = edge_cost(edgeId) + this_cell_data.pathCost;
+        const CostType cost = dlm.wireCost(edge, minUsage);
+        if (edge.type == HORIZ) {
+            colCost[edge.gcell1->x] = std::min(colCost[edge.gcell1->x], cost);
+        } else {
+            rowCost[edge.gcell1->y] = std::min(rowCost[edge.gcell1->y], cost);
+        }
+    }
+    dlmBound.assign(colCost, rowCost);
+}
 
-            // Calculate the total cost as detailed in the PQueue.setGCellCost function
-            const auto total_cost = manh_cost + path_cost;
+//@brief: label the connected components of the grid by flood fill. With `freeOnly`
+//        only edges with room for another wire connect, otherwise every edge does.
+void SimpleGR::buildComponents(bool freeOnly)
+{
+    GR_PROFILE_SCOPE("buildComponents");
 
-            // get the connecting cell id to insert it into the priority queue
-            const auto connecting_cell_id = getGCellId(connecting_cell);
+    const IdType numGCells = numLayers * gcellArrSzX * gcellArrSzY;
+    std::vector<IdType> labels(numGCells, NULLID);
+    std::vector<IdType> stack;
+    IdType numLabels = 0;
 
-            // insert the neighbor cell into the priority queue
-            if (!priorityQueue.isGCellVsted(connecting_cell_id)) {
-                priorityQueue.setGCellCost(connecting_cell_id, manh_cost, total_cost, this_cell_id);
-            } else {
-                const auto old_cost = priorityQueue.getGCellData(connecting_cell_id).totalCost;
-                if (old_cost > total_cost) {
-                    priorityQueue.setGCellCost(connecting_cell_id, manh_cost, total_cost, this_cell_id);
+    for (IdType seed = 0; seed < numGCells; ++seed) {
+        if (labels[seed] != NULLID) { continue; }
+        labels[seed] = numLabels;
+        stack.push_back(seed);
+        while (!stack.empty()) {
+            const IdType id = stack.back();
+            stack.pop_back();
+            for (const IdType edgeId : getGCellEdges(id)) {
+                const Edge &edge = grEdgeArr[edgeId];
+                if (freeOnly && !edgeHasRoom(edge)) { continue; }
+                const IdType next = getGCellId(*(edge.gcell1 == &getGCell(id) ? edge.gcell2 : edge.gcell1));
+                if (labels[next] == NULLID) {
+                    labels[next] = numLabels;
+                    stack.push_back(next);
                 }
             }
         }
+        ++numLabels;
+    }
 
-    } while (!priorityQueue.isEmpty());
+    (freeOnly ? freeComponents : gridComponents).assign(std::move(labels), numLabels);
+}
 
-    // now backtrace and build up the path, if we found one
-    // back-track from sink to source, and fill up 'path' vector with all the edges that are traversed
-    if (priorityQueue.isGCellVsted(dest_cell_id)) {
-        auto current_id = dest_cell_id;
+///////////////////////////////////////////////////////////////////////////////
+// Lee-style wavefront search for UnitEdgeCost. A wire costs one level and a via
+// viaFactor levels, so the search is a breadth-first sweep over levels instead of
+// a heap. The visited set and the wavefronts are bitsets with one row of words per
+// grid row and layer (WavefrontGrid): a level moves a whole row along x with a
+// shift and a mask of the +x edges, and along y or across vias with a mask alone.
+// Rows are only swept inside the box the wavefront can have reached by a level.
+// The gcells of a level get it recorded, and the path is traced back by stepping
+// to any neighbor one edge cost lower, so the cost is the same as exact A*'s.
+///////////////////////////////////////////////////////////////////////////////
+template<bool AllowOverflow, typename Stats>
+CostType SimpleGR::routeWavefront(Net &net,
+    const Point &bot_left,
+    const Point &top_right,
+    std::vector<Edge *> &path,
+    Stats &stats)
+{
+    GR_PROFILE_SCOPE("routeWavefront");
+
+    static constexpr uint32_t viaLevels = static_cast<uint32_t>(viaFactor);
+    static_assert(static_cast<CostType>(viaLevels) == viaFactor && viaLevels < WavefrontScratch::ring,
+        "the wavefront needs an integral via cost below its ring of pending levels");
+
+    stats.begin();
+
+    const IdType source_cell_id = getGCellId(net.gCellOne);
+    const IdType dest_cell_id = getGCellId(net.gCellTwo);
+
+    // a search of a parallel batch only reads the components
+    const bool parallel = searchShared;
+    GCellComponents &components = AllowOverflow ? gridComponents : freeComponents;
+    if (parallel ? !components.connectedShared(source_cell_id, dest_cell_id)
+                 : !components.connected(source_cell_id, dest_cell_id)) {
+        stats.end();
+        return std::numeric_limits<CostType>::max();
+    }
+
+    const IdType words = wavefront.words();
+    WavefrontScratch &scratch = searchWorker > 0 ? workerScratch[searchWorker - 1] : wavefrontScratch;
+    scratch.resize(wavefront.size(), words, static_cast<std::size_t>(numLayers) * gcellArrSzX * gcellArrSzY);
+    const uint64_t *xEdges = wavefront.xEdges(!AllowOverflow);
+    const uint64_t *yEdges = wavefront.yEdges(!AllowOverflow);
+
+    // bits [a, b] of word w
+    auto span = [](IdType w, CoordType a, CoordType b) -> uint64_t {
+        if (a > b || b < w * 64 || a > w * 64 + 63) { return 0; }
+        const CoordType first = std::max(a, w * 64) - w * 64, last = std::min(b, w * 64 + 63) - w * 64;
+        return (~uint64_t(0) >> (63 - last)) & (~uint64_t(0) << first);
+    };
 
-        // pre-allocate estimated space for the route path in order to minimize allocations
+    // the box clipped to the grid, and its columns as a mask
+    const CoordType loX = bot_left.x, loY = bot_left.y;
+    const CoordType hiX = std::min(top_right.x, gcellArrSzX - 1), hiY = std::min(top_right.y, gcellArrSzY - 1);
+    for (IdType w = loX / 64; w <= hiX / 64; ++w) { scratch.box[w] = span(w, loX, hiX); }
+
+    const bool unconstrained = loX == 0 && loY == 0 && hiX + 1 == gcellArrSzX && hiY + 1 == gcellArrSzY;
+
+    const Point &src = net.gCellOne;
+    const Point &dst = net.gCellTwo;
+    auto distance = [](CoordType a, CoordType b) { return a > b ? a - b : b - a; };
+
+    // rows and words holding bits of a level, over all layers; `touched` covers every
+    // word a sweep wrote
+    struct Region
+    {
+        CoordType y0, y1;
+        IdType w0, w1;
+        bool empty(void) const { return y0 > y1; }
+        void clear(void) { y0 = 1, y1 = 0, w0 = 1, w1 = 0; }
+        void add(const Region &o)
         {
-            const auto estimated_size = manhattanDistance(getGCell(source_cell_id), getGCell(dest_cell_id));
-            path.reserve(static_cast<std::size_t>(estimated_size) * 2);
+            if (o.empty()) { return; }
+            if (empty()) {
+                *this = o;
+                return;
+            }
+            y0 = std::min(y0, o.y0), y1 = std::max(y1, o.y1), w0 = std::min(w0, o.w0), w1 = std::max(w1, o.w1);
         }
+    };
+    const IdType loW = loX / 64, hiW = hiX / 64;
+    Region pendingRegion[WavefrontScratch::ring], touched;
+    touched.clear();
 
-        // clear the path in case it was already used
-        path.clear();
+    auto cleanUp = [&]() {
+        if (touched.empty()) { return; }
+        for (IdType z = 0; z < numLayers; ++z) {
+            for (CoordType y = touched.y0; y <= touched.y1; ++y) {
+                const std::size_t r = wavefront.row(z, y);
+                for (IdType w = touched.w0; w <= touched.w1; ++w) {
+                    scratch.visited[r + w] = 0;
+                    scratch.frontier[r + w] = 0;
+                    for (auto &p : scratch.pending) { p[r + w] = 0; }
+                }
+            }
+        }
+        touched.clear();
+    };
+
+    // One sweep from the source that skips the gcells whose level plus a lower bound
+    // on the levels left exceeds `budget`; that is A* with a consistent heuristic, so
+    // it finds the optimum whenever it fits the budget. Returns whether the destination
+    // was reached, `pruned` tells if anything was skipped.
+    uint32_t d = 0;
+    auto sweep = [&](uint32_t budget, bool &pruned) -> bool {
+        for (auto &region : pendingRegion) { region.clear(); }
+        scratch.pending[0][wavefront.row(src.z, src.y) + src.x / 64] |= uint64_t(1) << (src.x % 64);
+        pendingRegion[0] = Region{ src.y, src.y, src.x / 64, src.x / 64 };
+        touched.add(pendingRegion[0]);
+        for (d = 0;; ++d) {
+            const unsigned slot = d % WavefrontScratch::ring;
+            const Region pending = pendingRegion[slot];
+            if (pending.empty()) {
+                if (std::all_of(std::begin(pendingRegion), std::end(pendingRegion),
+                        [](const Region &region) { return region.empty(); })) {
+                    return false;
+                }
+                continue;
+            }
+            pendingRegion[slot].clear();
+
+            uint64_t *pend = scratch.pending[slot].data();
+            uint64_t *front = scratch.frontier.data();
+            uint64_t *visited = scratch.visited.data();
+
+            // the new wavefront: pending gcells not visited yet and within the budget,
+            // written where nonzero and cleared again once it has been advanced
+            Region frontier;
+            frontier.clear();
+            for (IdType z = 0; z < numLayers; ++z) {
+                for (CoordType y = pending.y0; y <= pending.y1; ++y) {
+                    const std::size_t r = wavefront.row(z, y);
+                    uint32_t *rowLevel = &scratch.level[gcellCoordToId(0, y, z)];
+                    // columns within the budget: those around dst.x, or dst.x alone where
+                    // no layer change is left to reach an x edge
+                    const CoordType dy = distance(y, dst.y);
+                    const int64_t left = static_cast<int64_t>(budget) - d - dy;
+                    const int64_t slack = left - viaLevels * wavefront.layerVias(z, dst.z, true, dy > 0);
+                    const bool column = left >= viaLevels * wavefront.layerVias(z, dst.z, false, dy > 0);
+                    CoordType a = 1, b = 0;
+                    if (slack >= 0) {
+                        a = dst.x - std::min<CoordType>(dst.x, static_cast<CoordType>(slack));
+                        b = static_cast<CoordType>(std::min<int64_t>(hiX, dst.x + slack));
+                    } else if (column) {
+                        a = b = dst.x;
+                    }
+                    for (IdType w = pending.w0; w <= pending.w1; ++w) {
+                        const uint64_t p = pend[r + w] & ~visited[r + w];
+                        pend[r + w] = 0;
+                        if (!p) { continue; }
+                        const uint64_t f = p & span(w, a, b);
+                        front[r + w] = f;
+                        if (p != f) { pruned = true; }
+                        if (!f) { continue; }
+                        visited[r + w] |= f;
+                        frontier.add(Region{ y, y, w, w });
+                        for (uint64_t bits = f; bits; bits &= bits - 1) {
+                            rowLevel[w * 64 + static_cast<CoordType>(__builtin_ctzll(bits))] = d;
+                            stats.expand();
+                        }
+                    }
+                }
+            }
+            if (frontier.empty()) { continue; }
+            if (visited[wavefront.row(dst.z, dst.y) + dst.x / 64] & (uint64_t(1) << (dst.x % 64))) { return true; }
 
-        while (current_id != source_cell_id) {
-            const auto &current_node = priorityQueue.getGCellData(current_id);
-            const auto parent_id = current_node.parentGCell;
+            // advance it by one wire, or one via
+            const unsigned wireSlot = (d + 1) % WavefrontScratch::ring;
+            const unsigned viaSlot = (d + viaLevels) % WavefrontScratch::ring;
+            uint64_t *wire = scratch.pending[wireSlot].data();
+            uint64_t *via = scratch.pending[viaSlot].data();
+            const IdType nw0 = std::max(loW + 1, frontier.w0) - 1, nw1 = std::min(hiW, frontier.w1 + 1);
+            const std::size_t layerWords = wavefront.row(1, 0);
+            uint64_t moved = 0;
+            for (IdType z = 0; z < numLayers; ++z) {
+                for (CoordType y = frontier.y0; y <= frontier.y1; ++y) {
+                    const std::size_t r = wavefront.row(z, y);
+                    const uint64_t *f = front + r;
+                    const uint64_t *xe = xEdges + r;
+                    uint64_t *out = wire + r;
+                    // along x: +x over the edge leaving a gcell, -x over the one entering it;
+                    // the frontier is zero outside its region, so the carry starts empty
+                    uint64_t carry = 0;
+                    for (IdType w = nw0; w <= nw1; ++w) {
+                        const uint64_t cur = f[w] & xe[w];
+                        const uint64_t next = w + 1 < words ? f[w + 1] : 0;
+                        const uint64_t step =
+                            ((cur << 1) | carry | (((f[w] >> 1) | (next << 63)) & xe[w])) & scratch.box[w];
+                        carry = cur >> 63;
+                        out[w] |= step;
+                        moved |= step;
+                    }
+                    // along y, up over this row's +y edges and down over the row below's
+                    const bool up = y < hiY, down = y > loY;
+                    // vias join every gcell to the ones above and below it
+                    uint64_t *above = z + 1 < numLayers ? via + r + layerWords : nullptr;
+                    uint64_t *below = z > 0 ? via + r - layerWords : nullptr;
+                    for (IdType w = frontier.w0; w <= frontier.w1; ++w) {
+                        const uint64_t cur = f[w];
+                        if (!cur) { continue; }
+                        if (up) {
+                            const uint64_t step = cur & yEdges[r + w];
+                            out[words + w] |= step;
+                            moved |= step;
+                        }
+                        if (down) {
+                            const uint64_t step = cur & yEdges[r - words + w];
+                            (out - words)[w] |= step;
+                            moved |= step;
+                        }
+                        if (above) { above[w] |= cur; }
+                        if (below) { below[w] |= cur; }
+                    }
+                    std::fill(front + r + frontier.w0, front + r + frontier.w1 + 1, uint64_t(0));
+                }
+            }
+            if (moved) {
+                const Region next{ std::max(loY + 1, frontier.y0) - 1, std::min(hiY, frontier.y1 + 1), nw0, nw1 };
+                pendingRegion[wireSlot].add(next);
+                touched.add(next);
+            }
+            if (numLayers > 1) {
+                pendingRegion[viaSlot].add(frontier);
+                touched.add(frontier);
+            }
+        }
+    };
 
-            auto &edge = get_edge(current_id, parent_id);
-            path.push_back(&edge);// this vector expects a pointer, for some reason
+    // start from the lower bound itself, and widen the budget until the sweep either
+    // reaches the destination or fails without having skipped anything
+    uint32_t budget = distance(src.x, dst.x) + distance(src.y, dst.y)
+                      + viaLevels * wavefront.layerVias(src.z, dst.z, src.x != dst.x, src.y != dst.y);
+    bool found = false;
+    for (bool pruned = true; pruned;) {
+        pruned = false;
+        found = sweep(budget, pruned);
+        if (found || !pruned) { break; }
+        cleanUp();
+        budget += std::max(2 * viaLevels, budget / 2);
+    }
 
-            current_id = parent_id;
+    // trace back from the destination, to any neighbor exactly one edge cost closer
+    path.clear();
+    if (found) {
+        const uint64_t *visited = scratch.visited.data();
+        auto reachedAt = [&](IdType id, uint32_t lvl) {
+            const Point p = gcellIdtoCoord(id);
+            return p.x >= loX && p.x <= hiX && p.y >= loY && p.y <= hiY
+                   && (visited[wavefront.row(p.z, p.y) + p.x / 64] & (uint64_t(1) << (p.x % 64)))
+                   && scratch.level[id] == lvl;
+        };
+        IdType cur = dest_cell_id;
+        while (cur != source_cell_id) {
+            const GCell &cell = getGCell(cur);
+            const uint32_t lvl = scratch.level[cur];
+            for (const IdType edgeId : getGCellEdges(cell)) {
+                Edge &edge = grEdgeArr[edgeId];
+                const uint32_t step = edge.type == VIA ? viaLevels : 1;
+                if (step > lvl || (!AllowOverflow && !edgeHasRoom(edge))) { continue; }
+                const IdType prev = getGCellId(*(edge.gcell1 == &cell ? edge.gcell2 : edge.gcell1));
+                if (reachedAt(prev, lvl - step)) {
+                    path.push_back(&edge);
+                    cur = prev;
+                    break;
+                }
+            }
         }
+    } else if (unconstrained && !parallel) {
+        // a failed search over the whole grid visited exactly its source's component
+        std::vector<IdType> reached;
+        for (IdType z = 0; z < numLayers; ++z) {
+            for (CoordType y = 0; y < gcellArrSzY; ++y) {
+                const std::size_t r = wavefront.row(z, y);
+                for (IdType w = 0; w < words; ++w) {
+                    for (uint64_t bits = scratch.visited[r + w]; bits; bits &= bits - 1) {
+                        reached.push_back(gcellCoordToId(w * 64 + static_cast<CoordType>(__builtin_ctzll(bits)), y, z));
+                    }
+                }
+            }
+        }
+        components.split(reached);
     }
 
-    // calculate the accumulated cost of the path
-    const CostType finalCost = priorityQueue.isGCellVsted(dest_cell_id)
-                                   ? priorityQueue.getGCellData(dest_cell_id).pathCost
-                                   : std::numeric_limits<CostType>::max();
+    cleanUp();
+    for (IdType w = loW; w <= hiW; ++w) { scratch.box[w] = 0; }
+
+    const CostType finalCost = found ? static_cast<CostType>(d) * edgeBase : std::numeric_limits<CostType>::max();
+    // the search is exact, its own lower bound
+    if (found && searchWeight > 1.f) {
+        (searchWorker > 0 ? workerBounds[searchWorker - 1] : searchBound).add(finalCost, finalCost);
+    }
+
+    stats.end();
+
+    return finalCost;
+}
+
+//@brief: fill the wavefront grid with the edges of every gcell and whether they have room
+void SimpleGR::buildWavefront(void)
+{
+    wavefront.resize(gcellArrSzX, gcellArrSzY, numLayers);
+    for (IdType z = 0; z < numLayers; ++z) {
+        for (CoordType y = 0; y < gcellArrSzY; ++y) {
+            for (CoordType x = 0; x < gcellArrSzX; ++x) {
+                const GCell &cell = gcellArr3D[z][y][x];
+                if (cell.incX != NULLID) { wavefront.addEdge(grEdgeArr[cell.incX], edgeHasRoom(grEdgeArr[cell.incX])); }
+                if (cell.incY != NULLID) { wavefront.addEdge(grEdgeArr[cell.incY], edgeHasRoom(grEdgeArr[cell.incY])); }
+            }
+        }
+    }
+    wavefront.findLayerVias(numLayers);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Parallel delta-stepping for one long net. The gcells are ordered by their A*
+// key (path cost plus the heuristic) in buckets `delta` wide, and the buckets are
+// expanded in order by all threads together: each light round the gcells queued
+// in the current bucket are split among the threads, which relax their edges
+// with an atomic minimum on the labels and queue the improved gcells by key. A
+// bucket is done when a round queues nothing more into it, and the search ends
+// at the first bucket whose keys reach the destination's cost. The heuristic is
+// consistent, so that cost is the optimum, the same as exact routeMaze; the path
+// is traced back over neighbors whose label plus edge cost gives exactly the
+// label, which does not depend on the order the threads ran in.
+///////////////////////////////////////////////////////////////////////////////
+template<typename Cost, bool AllowOverflow, typename Stats>
+CostType SimpleGR::routeDelta(Net &net,
+    const Point &bot_left,
+    const Point &top_right,
+    Cost edge_cost,
+    std::vector<Edge *> &path,
+    Stats &stats)
+{
+    GR_PROFILE_SCOPE("routeDelta");
+
+    stats.begin();
+
+    const IdType source_cell_id = getGCellId(net.gCellOne);
+    const IdType dest_cell_id = getGCellId(net.gCellTwo);
+
+    GCellComponents &components = AllowOverflow ? gridComponents : freeComponents;
+    if (!components.connected(source_cell_id, dest_cell_id)) {
+        stats.end();
+        return std::numeric_limits<CostType>::max();
+    }
+
+    const PathLowerBound &heuristic = pathBound(edge_cost);
+    const GCell &dest_cell = getGCell(dest_cell_id);
+    const unsigned threads = longNetThreads;
+    DeltaScratch &scratch = deltaScratch;
+    scratch.resize(static_cast<std::size_t>(numLayers) * gcellArrSzX * gcellArrSzY, threads);
+    scratch.beginSearch();
+
+    auto toBits = [](CostType cost) {
+        uint32_t bits;
+        std::memcpy(&bits, &cost, sizeof(bits));
+        return bits;
+    };
+    auto fromBits = [](uint32_t bits) {
+        CostType cost;
+        std::memcpy(&cost, &bits, sizeof(cost));
+        return cost;
+    };
+    auto in_bounding_box = [&bot_left, &top_right](const GCell &cell) {
+        return (bot_left.x <= cell.x && cell.x <= top_right.x) && (bot_left.y <= cell.y && cell.y <= top_right.y);
+    };
+    auto usable = [this](const IdType edge_id) { return AllowOverflow || edgeHasRoom(grEdgeArr[edge_id]); };
+
+    // one via wide, so a bucket takes the detours of one layer change
+    static constexpr CostType delta = viaFactor * edgeBase;
+    static constexpr std::size_t none = std::numeric_limits<std::size_t>::max();
+    auto bucketOf = [](CostType key, std::size_t lowest) {
+        return std::max(lowest, static_cast<std::size_t>(key / delta));
+    };
+    // gcells each thread has in its buckets, for the peak queue size of the stats
+    std::vector<std::size_t> inBuckets(threads, 0), atRound(threads, 0);
+    auto enqueue = [&scratch, &inBuckets](unsigned worker, std::size_t bucket, IdType id) {
+        auto &buckets = scratch.buckets[worker];
+        if (bucket >= buckets.size()) { buckets.resize(bucket + 1); }
+        buckets[bucket].push_back(id);
+        ++inBuckets[worker];
+    };
+
+    scratch.labels[source_cell_id].store(toBits(0.f), std::memory_order_relaxed);
+    scratch.touched[0].push_back(source_cell_id);
+    enqueue(0, bucketOf(heuristic(getGCell(source_cell_id), dest_cell), 0), source_cell_id);
+
+    Barrier barrier(threads);
+    std::atomic<std::size_t> nextBucket{ none };
+    std::vector<std::size_t> counts(threads, 0);
+    std::vector<uint64_t> expanded(threads, 0), relaxed(threads, 0);
+    std::size_t peak = 0;
+    const uint32_t firstRound = scratch.round;
+    uint32_t lastRound = firstRound;
+    const bool abortable = searchDeadline;
+    bool aborted = false;// written by worker 0 only, between barriers
+
+    // relax the edges of one queued gcell, unless it was already expanded this round
+    auto expand = [&](unsigned worker, IdType id, uint32_t round, std::size_t bucket) {
+        if (scratch.stamps[id].exchange(round, std::memory_order_relaxed) == round) { return; }
+        ++expanded[worker];
+        const CostType cost = fromBits(scratch.labels[id].load(std::memory_order_relaxed));
+        const GCell &cell = getGCell(id);
+        for (const IdType edgeId : getGCellEdges(cell)) {
+            if (!usable(edgeId)) { continue; }
+            const Edge &edge = grEdgeArr[edgeId];
+            const GCell &next = edge.gcell1 == &cell ? *edge.gcell2 : *edge.gcell1;
+            if (!in_bounding_box(next)) { continue; }
+            const CostType nextCost = cost + edge_cost(edgeId);
+            const uint32_t bits = toBits(nextCost);
+            const IdType nextId = getGCellId(next);
+            std::atomic<uint32_t> &label = scratch.labels[nextId];
+            uint32_t old = label.load(std::memory_order_relaxed);
+            while (bits < old && !label.compare_exchange_weak(old, bits, std::memory_order_relaxed)) {}
+            if (bits >= old) { continue; }
+            if (old == DeltaScratch::unreached) { scratch.touched[worker].push_back(nextId); }
+            ++relaxed[worker];
+            enqueue(worker, bucketOf(nextCost + heuristic(next, dest_cell), bucket), nextId);
+        }
+    };
+
+    deltaPool.run(threads, [&](unsigned worker) {
+        auto &buckets = scratch.buckets[worker];
+        uint32_t round = firstRound;
+        std::size_t bucket = 0;
+        for (;;) {
+            // the lowest bucket any thread has gcells in
+            std::size_t mine = bucket;
+            while (mine < buckets.size() && buckets[mine].empty()) { ++mine; }
+            if (mine < buckets.size()) {
+                std::size_t seen = nextBucket.load(std::memory_order_relaxed);
+                while (mine < seen && !nextBucket.compare_exchange_weak(seen, mine, std::memory_order_relaxed)) {}
+            }
+            // with a -deadline, give up between buckets once it passes
+            if (worker == 0 && abortable && timeUp()) { aborted = true; }
+            barrier.wait();
+            bucket = nextBucket.load(std::memory_order_relaxed);
+            const CostType destCost = fromBits(scratch.labels[dest_cell_id].load(std::memory_order_relaxed));
+            const bool stop = aborted;
+            barrier.wait();
+            if (worker == 0) { nextBucket.store(none, std::memory_order_relaxed); }
+            if (stop || bucket == none || static_cast<CostType>(bucket) * delta >= destCost) { break; }
+
+            // light rounds until the bucket stays empty
+            for (;;) {
+                auto &current = scratch.current[worker];
+                current.clear();
+                if (bucket < buckets.size()) { current.swap(buckets[bucket]); }
+                counts[worker] = current.size();
+                atRound[worker] = inBuckets[worker];
+                inBuckets[worker] -= current.size();
+                barrier.wait();
+                std::size_t total = 0;
+                for (const std::size_t count : counts) { total += count; }
+                if (worker == 0) {
+                    std::size_t all = 0;
+                    for (const std::size_t count : atRound) { all += count; }
+                    peak = std::max(peak, all);
+                }
+                if (total == 0) { break; }
+                ++round;
+
+                // an even share of all queued gcells, whichever thread queued them
+                const std::size_t begin = total * worker / threads, end = total * (worker + 1) / threads;
+                std::size_t base = 0;
+                for (unsigned w = 0; w < threads; ++w) {
+                    const auto &items = scratch.current[w];
+                    const std::size_t lo = std::max(begin, base), hi = std::min(end, base + items.size());
+                    for (std::size_t k = lo; k < hi; ++k) { expand(worker, items[k - base], round, bucket); }
+                    base += items.size();
+                }
+                barrier.wait();
+            }
+        }
+        if (worker == 0) { lastRound = round; }
+    });
+    scratch.round = lastRound;
+
+    for (unsigned w = 0; w < threads; ++w) { stats.add(expanded[w], relaxed[w], w == 0 ? peak : 0); }
+
+    // trace back from the destination over edges that account for the labels exactly
+    path.clear();
+    const uint32_t destBits = scratch.labels[dest_cell_id].load(std::memory_order_relaxed);
+    const bool found = !aborted && destBits != DeltaScratch::unreached;
+    bool traced = found;
+    if (found) {
+        IdType cur = dest_cell_id;
+        while (cur != source_cell_id) {
+            const GCell &cell = getGCell(cur);
+            const CostType cost = fromBits(scratch.labels[cur].load(std::memory_order_relaxed));
+            IdType prev = NULLID;
+            for (const IdType edgeId : getGCellEdges(cell)) {
+                if (!usable(edgeId)) { continue; }
+                Edge &edge = grEdgeArr[edgeId];
+                const GCell &from = edge.gcell1 == &cell ? *edge.gcell2 : *edge.gcell1;
+                if (!in_bounding_box(from)) { continue; }
+                const IdType fromId = getGCellId(from);
+                const uint32_t bits = scratch.labels[fromId].load(std::memory_order_relaxed);
+                if (bits != DeltaScratch::unreached && fromBits(bits) + edge_cost(edgeId) == cost) {
+                    path.push_back(&edge);
+                    prev = fromId;
+                    break;
+                }
+            }
+            // no edge accounts for the label exactly; routeMaze searches the net again below
+            if (prev == NULLID) {
+                traced = false;
+                break;
+            }
+            cur = prev;
+        }
+    }
 
     // clean up
-    priorityQueue.clear();
+    for (unsigned w = 0; w < threads; ++w) {
+        for (const IdType id : scratch.touched[w]) {
+            scratch.labels[id].store(DeltaScratch::unreached, std::memory_order_relaxed);
+        }
+        scratch.touched[w].clear();
+        for (auto &queued : scratch.buckets[w]) { queued.clear(); }
+        scratch.current[w].clear();
+    }
+
+    // the retry's counts and time go into this search's record
+    if (found && !traced) {
+        path.clear();
+        Stats retry;
+        const CostType cost = routeMaze<Cost, AllowOverflow>(net, bot_left, top_right, edge_cost, path, retry);
+        stats.add(retry);
+        stats.end();
+        return cost;
+    }
+
+    const CostType finalCost = found ? fromBits(destBits) : std::numeric_limits<CostType>::max();
+    // the search is exact, its own lower bound
+    if (found && searchWeight > 1.f) { searchBound.add(finalCost, finalCost); }
+
+    stats.end();
 
     return finalCost;
 }
+
+#define GR_INSTANTIATE_ROUTEMAZE(COST, ALLOW, STATS)                                                                \
+    template CostType SimpleGR::routeMaze<COST, ALLOW, STATS>(                                                         \
+        Net &, const Point &, const Point &, COST, std::vector<Edge *> &, STATS &);
+
+GR_INSTANTIATE_ROUTEMAZE(UnitEdgeCost, false, NoSearchStats)
+GR_INSTANTIATE_ROUTEMAZE(UnitEdgeCost, true, NoSearchStats)
+GR_INSTANTIATE_ROUTEMAZE(DLMEdgeCost, false, NoSearchStats)
+GR_INSTANTIATE_ROUTEMAZE(DLMEdgeCost, true, NoSearchStats)
+GR_INSTANTIATE_ROUTEMAZE(UnitEdgeCost, false, SearchStats)
+GR_INSTANTIATE_ROUTEMAZE(UnitEdgeCost, true, SearchStats)
+GR_INSTANTIATE_ROUTEMAZE(DLMEdgeCost, false, SearchStats)
+GR_INSTANTIATE_ROUTEMAZE(DLMEdgeCost, true, SearchStats)
+
+#undef GR_INSTANTIATE_ROUTEMAZE
+
+#define GR_INSTANTIATE_ROUTEDELTA(COST, ALLOW, STATS)                                                               \
+    template CostType SimpleGR::routeDelta<COST, ALLOW, STATS>(                                                        \
+        Net &, const Point &, const Point &, COST, std::vector<Edge *> &, STATS &);
+
+GR_INSTANTIATE_ROUTEDELTA(UnitEdgeCost, false, NoSearchStats)
+GR_INSTANTIATE_ROUTEDELTA(UnitEdgeCost, true, NoSearchStats)
+GR_INSTANTIATE_ROUTEDELTA(DLMEdgeCost, false, NoSearchStats)
+GR_INSTANTIATE_ROUTEDELTA(DLMEdgeCost, true, NoSearchStats)
+GR_INSTANTIATE_ROUTEDELTA(UnitEdgeCost, false, SearchStats)
+GR_INSTANTIATE_ROUTEDELTA(UnitEdgeCost, true, SearchStats)
+GR_INSTANTIATE_ROUTEDELTA(DLMEdgeCost, false, SearchStats)
+GR_INSTANTIATE_ROUTEDELTA(DLMEdgeCost, true, SearchStats)
+
+#undef GR_INSTANTIATE_ROUTEDELTA
+
+#define GR_INSTANTIATE_ROUTETREE(COST, ALLOW)                                                                          \
+    template void SimpleGR::routeTree<COST, ALLOW>(IdType,                                                             \
+        const std::vector<IdType> &,                                                                                   \
+        const Point &,                                                                                                 \
+        const Point &,                                                                                                 \
+        COST,                                                                                                          \
+        std::vector<std::vector<Edge *>> &,                                                                            \
+        std::vector<CostType> &);
+
+GR_INSTANTIATE_ROUTETREE(UnitEdgeCost, false)
+GR_INSTANTIATE_ROUTETREE(UnitEdgeCost, true)
+GR_INSTANTIATE_ROUTETREE(DLMEdgeCost, false)
+GR_INSTANTIATE_ROUTETREE(DLMEdgeCost, true)
+
+#undef GR_INSTANTIATE_ROUTETREE
+
+#define GR_INSTANTIATE_ROUTEWAVEFRONT(ALLOW, STATS)                                                                    \
+    template CostType SimpleGR::routeWavefront<ALLOW, STATS>(                                                          \
+        Net &, const Point &, const Point &, std::vector<Edge *> &, STATS &);
+
+GR_INSTANTIATE_ROUTEWAVEFRONT(false, NoSearchStats)
+GR_INSTANTIATE_ROUTEWAVEFRONT(true, NoSearchStats)
+GR_INSTANTIATE_ROUTEWAVEFRONT(false, SearchStats)
+GR_INSTANTIATE_ROUTEWAVEFRONT(true, SearchStats)
+
+#undef GR_INSTANTIATE_ROUTEWAVEFRONT
@@ -0,0 +1,158 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//@brief: number of threads for a -threads value, 0 meaning one per hardware thread
+inline unsigned resolveThreads(unsigned requested)
+{
+    if (requested > 0) { return requested; }
+    return std::max(1U, std::thread::hardware_concurrency());
+}
+
+//@brief: calls fn(i, worker) for every i in [0, count) on `threads` threads. The calling
+//        thread is worker 0 and the others are numbered from 1; items are handed out one
+//        at a time, so uneven items balance themselves. Returns when all are done.
+template<typename Fn> void parallelFor(std::size_t count, unsigned threads, Fn &&fn)
+{
+    const unsigned workers = static_cast<unsigned>(std::min<std::size_t>(std::max(1U, threads), count));
+    if (workers <= 1) {
+        for (std::size_t i = 0; i < count; ++i) { fn(i, 0U); }
+        return;
+    }
+
+    std::atomic<std::size_t> next{ 0 };
+    auto work = [&](unsigned worker) {
+        for (std::size_t i = next.fetch_add(1, std::memory_order_relaxed); i < count;
+             i = next.fetch_add(1, std::memory_order_relaxed)) {
+            fn(i, worker);
+        }
+    };
+
+    std::vector<std::thread> pool;
+    pool.reserve(workers - 1);
+    for (unsigned w = 1; w < workers; ++w) { pool.emplace_back(work, w); }
+    work(0);
+    for (auto &t : pool) { t.join(); }
+}
+
+//@brief: calls fn(worker) exactly once on each of `threads` threads, the calling thread
+//        being worker 0, for workers that synchronize with each other through a Barrier
+template<typename Fn> void runWorkers(unsigned threads, Fn &&fn)
+{
+    std::vector<std::thread> pool;
+    pool.reserve(threads > 0 ? threads - 1 : 0);
+    for (unsigned w = 1; w < threads; ++w) { pool.emplace_back(fn, w); }
+    fn(0U);
+    for (auto &t : pool) { t.join(); }
+}
+
+//@brief: runWorkers on threads kept between runs, for work run many times in a row (one
+//        search per long net) where starting threads each time would cost more than the
+//        work. The threads are started by the first run that needs them and wait for the
+//        next one. Runs must not overlap, and fn must not run on the same pool.
+class WorkerPool
+{
+  public:
+    WorkerPool() = default;
+    WorkerPool(const WorkerPool &) = delete;
+    WorkerPool &operator=(const WorkerPool &) = delete;
+    ~WorkerPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+            ++generation_;
+        }
+        wake_.notify_all();
+        for (auto &t : pool_) { t.join(); }
+    }
+
+    template<typename Fn> void run(unsigned threads, Fn &&fn)
+    {
+        if (threads <= 1) {
+            fn(0U);
+            return;
+        }
+        while (pool_.size() + 1 < threads) {
+            pool_.emplace_back(&WorkerPool::loop, this, static_cast<unsigned>(pool_.size() + 1));
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            job_ = [&fn](unsigned worker) { fn(worker); };
+            active_ = threads;
+            pending_ = threads - 1;
+            ++generation_;
+        }
+        wake_.notify_all();
+        fn(0U);
+        std::unique_lock<std::mutex> lock(mutex_);
+        done_.wait(lock, [&]() { return pending_ == 0; });
+        job_ = nullptr;
+    }
+
+  private:
+    void loop(unsigned worker)
+    {
+        unsigned seen = 0;
+        std::unique_lock<std::mutex> lock(mutex_);
+        for (;;) {
+            wake_.wait(lock, [&]() { return generation_ != seen; });
+            seen = generation_;
+            if (stopping_) { return; }
+            // a run on fewer threads leaves this one waiting
+            if (worker >= active_) { continue; }
+            lock.unlock();
+            job_(worker);
+            lock.lock();
+            if (--pending_ == 0) { done_.notify_one(); }
+        }
+    }
+
+    std::vector<std::thread> pool_;
+    std::mutex mutex_;
+    std::condition_variable wake_, done_;
+    std::function<void(unsigned)> job_;
+    unsigned generation_{ 0 }, active_{ 0 }, pending_{ 0 };
+    bool stopping_{ false };
+};
+
+//@brief: reusable barrier for a fixed number of threads. A waiting thread spins briefly,
+//        since the phases it separates are often short, then sleeps.
+class Barrier
+{
+  public:
+    explicit Barrier(unsigned count) : count_(count) {}
+
+    void wait(void)
+    {
+        const unsigned generation = generation_.load(std::memory_order_acquire);
+        if (arrived_.fetch_add(1, std::memory_order_acq_rel) + 1 == count_) {
+            arrived_.store(0, std::memory_order_relaxed);
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                generation_.store(generation + 1, std::memory_order_release);
+            }
+            wake_.notify_all();
+            return;
+        }
+        for (unsigned spin = 0; spin < 1024; ++spin) {
+            if (generation_.load(std::memory_order_acquire) != generation) { return; }
+        }
+        std::unique_lock<std::mutex> lock(mutex_);
+        wake_.wait(lock, [&]() { return generation_.load(std::memory_order_acquire) != generation; });
+    }
+
+  private:
+    const unsigned count_;
+    std::atomic<unsigned> arrived_{ 0 };
+    std::atomic<unsigned> generation_{ 0 };
+    std::mutex mutex_;
+    std::condition_variable wake_;
+};
@@ -0,0 +1,167 @@
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <mutex>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "Profiler.h"
+
+namespace prof {
+
+namespace {
+
+    // Owns all sites. The summary is printed from the destructor, which runs at
+    // process exit after every scope has been closed.
+    class Registry
+    {
+      public:
+        ~Registry() { printSummary(); }
+
+        Site &get(const char *name)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (auto &s : sites_) {
+                if (std::strcmp(s.name(), name) == 0) { return s; }
+            }
+            sites_.emplace_back(name);
+            return sites_.back();
+        }
+
+      private:
+        void printSummary(void)
+        {
+            bool any = false;
+            bool anyHw = false;
+            for (const auto &s : sites_) {
+                any = any || s.calls() > 0;
+                anyHw = anyHw || s.hwValid();
+            }
+            if (!any) { return; }
+
+            std::fprintf(stderr, "\nProfile summary (wall clock):\n");
+            std::fprintf(stderr, "%-28s %12s %12s %12s", "scope", "calls", "total ms", "avg us");
+            if (anyHw) { std::fprintf(stderr, " %14s %12s %12s", "cycles", "cache-miss", "branch-miss"); }
+            std::fprintf(stderr, "\n");
+
+            for (const auto &s : sites_) {
+                if (s.calls() == 0) { continue; }
+                const double totalMs = static_cast<double>(s.nanos()) * 1.e-6;
+                const double avgUs = static_cast<double>(s.nanos()) * 1.e-3 / static_cast<double>(s.calls());
+                std::fprintf(stderr,
+                    "%-28s %12llu %12.3f %12.3f",
+                    s.name(),
+                    static_cast<unsigned long long>(s.calls()),
+                    totalMs,
+                    avgUs);
+                if (s.hwValid()) {
+                    std::fprintf(stderr,
+                        " %14llu %12llu %12llu",
+                        static_cast<unsigned long long>(s.cycles()),
+                        static_cast<unsigned long long>(s.cacheMisses()),
+                        static_cast<unsigned long long>(s.branchMisses()));
+                } else if (anyHw) {
+                    std::fprintf(stderr, " %14s %12s %12s", "-", "-", "-");
+                }
+                std::fprintf(stderr, "\n");
+            }
+            if (!anyHw) { std::fprintf(stderr, "(hardware counters unavailable)\n"); }
+        }
+
+        std::mutex mutex_;
+        std::deque<Site> sites_;
+    };
+
+    Registry &registry(void)
+    {
+        static Registry reg;
+        return reg;
+    }
+
+#ifdef __linux__
+    // One counter group per thread: cycles leads, cache and branch misses follow.
+    class HwCounters
+    {
+      public:
+        HwCounters()
+        {
+            leader_ = open(PERF_COUNT_HW_CPU_CYCLES, -1);
+            if (leader_ < 0) { return; }
+            cache_ = open(PERF_COUNT_HW_CACHE_MISSES, leader_);
+            branch_ = open(PERF_COUNT_HW_BRANCH_MISSES, leader_);
+            if (cache_ < 0 || branch_ < 0) {
+                closeAll();
+                return;
+            }
+            ioctl(leader_, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+            ioctl(leader_, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+        }
+        ~HwCounters() { closeAll(); }
+
+        HwSample read(void) const
+        {
+            HwSample sample;
+            if (leader_ < 0) { return sample; }
+
+            // PERF_FORMAT_GROUP layout: nr, then one value per counter
+            uint64_t buf[4] = { 0, 0, 0, 0 };
+            if (::read(leader_, buf, sizeof(buf)) != static_cast<ssize_t>(sizeof(buf)) || buf[0] != 3) {
+                return sample;
+            }
+            sample.cycles = buf[1];
+            sample.cacheMisses = buf[2];
+            sample.branchMisses = buf[3];
+            sample.valid = true;
+            return sample;
+        }
+
+      private:
+        static int open(uint64_t config, int groupFd)
+        {
+            perf_event_attr attr;
+            std::memset(&attr, 0, sizeof(attr));
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.size = sizeof(attr);
+            attr.config = config;
+            if (groupFd < 0) { attr.disabled = 1; }
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            attr.read_format = PERF_FORMAT_GROUP;
+            return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, groupFd, 0));
+        }
+
+        void closeAll(void)
+        {
+            if (branch_ >= 0) { close(branch_); }
+            if (cache_ >= 0) { close(cache_); }
+            if (leader_ >= 0) { close(leader_); }
+            leader_ = cache_ = branch_ = -1;
+        }
+
+        int leader_{ -1 };
+        int cache_{ -1 };
+        int branch_{ -1 };
+    };
+#endif
+
+}// namespace
+
+Site &site(const char *name) { return registry().get(name); }
+
+HwSample readHwCounters(void)
+{
+#ifdef __linux__
+    thread_local HwCounters counters;
+    return counters.read();
+#else
+    return HwSample();
+#endif
+}
+
+}// namespace prof
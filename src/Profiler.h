@@ -0,0 +1,124 @@
+#pragma once
+
+// Lightweight instrumentation for SimpleGR.
+//
+// Scopes are only compiled in when GR_PROFILE is defined (cmake -DGR_ENABLE_PROFILING=ON),
+// otherwise the macros below expand to nothing and cost nothing.
+//
+//  GR_PROFILE_SCOPE(name) : wall time and call count, cheap enough for hot paths
+//  GR_PROFILE_PHASE(name) : same as above plus hardware counters (cycles, cache misses,
+//                           branch misses) read through perf_event_open where available
+//
+// A summary table of every scope that was entered is printed to stderr at exit.
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace prof {
+
+// hardware counters sampled by phase scopes
+struct HwSample
+{
+    uint64_t cycles{ 0 };
+    uint64_t cacheMisses{ 0 };
+    uint64_t branchMisses{ 0 };
+    bool valid{ false };
+};
+
+// accumulated statistics for one named scope
+class Site
+{
+  public:
+    explicit Site(const char *name) : name_(name) {}
+
+    void record(uint64_t nanos, const HwSample &hw)
+    {
+        calls_.fetch_add(1, std::memory_order_relaxed);
+        nanos_.fetch_add(nanos, std::memory_order_relaxed);
+        if (hw.valid) {
+            hwValid_.store(true, std::memory_order_relaxed);
+            cycles_.fetch_add(hw.cycles, std::memory_order_relaxed);
+            cacheMisses_.fetch_add(hw.cacheMisses, std::memory_order_relaxed);
+            branchMisses_.fetch_add(hw.branchMisses, std::memory_order_relaxed);
+        }
+    }
+
+    const char *name() const { return name_; }
+    uint64_t calls() const { return calls_.load(std::memory_order_relaxed); }
+    uint64_t nanos() const { return nanos_.load(std::memory_order_relaxed); }
+    bool hwValid() const { return hwValid_.load(std::memory_order_relaxed); }
+    uint64_t cycles() const { return cycles_.load(std::memory_order_relaxed); }
+    uint64_t cacheMisses() const { return cacheMisses_.load(std::memory_order_relaxed); }
+    uint64_t branchMisses() const { return branchMisses_.load(std::memory_order_relaxed); }
+
+  private:
+    const char *name_;
+    std::atomic<uint64_t> calls_{ 0 };
+    std::atomic<uint64_t> nanos_{ 0 };
+    std::atomic<bool> hwValid_{ false };
+    std::atomic<uint64_t> cycles_{ 0 };
+    std::atomic<uint64_t> cacheMisses_{ 0 };
+    std::atomic<uint64_t> branchMisses_{ 0 };
+};
+
+//@brief: returns the site registered under `name`, creating it on first use.
+//        Sites live until the summary has been printed at exit.
+Site &site(const char *name);
+
+//@brief: reads the calling thread's hardware counters. The returned sample is
+//        marked invalid if perf_event_open is unavailable (non-Linux, sandboxed, ...)
+HwSample readHwCounters(void);
+
+//@brief: RAII scope, records elapsed wall time (and optionally hw counters) into a site
+class Scope
+{
+  public:
+    Scope(Site &s, bool withHw) : site_(s), withHw_(withHw)
+    {
+        if (withHw_) { hwStart_ = readHwCounters(); }
+        start_ = std::chrono::steady_clock::now();
+    }
+
+    ~Scope()
+    {
+        const auto elapsed = std::chrono::steady_clock::now() - start_;
+        HwSample delta;
+        if (withHw_ && hwStart_.valid) {
+            const HwSample hwEnd = readHwCounters();
+            if (hwEnd.valid) {
+                delta.cycles = hwEnd.cycles - hwStart_.cycles;
+                delta.cacheMisses = hwEnd.cacheMisses - hwStart_.cacheMisses;
+                delta.branchMisses = hwEnd.branchMisses - hwStart_.branchMisses;
+                delta.valid = true;
+            }
+        }
+        site_.record(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()),
+            delta);
+    }
+
+    Scope(const Scope &) = delete;
+    Scope &operator=(const Scope &) = delete;
+
+  private:
+    Site &site_;
+    bool withHw_;
+    HwSample hwStart_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+}// namespace prof
+
+#define GR_PROFILE_CONCAT_(a, b) a##b
+#define GR_PROFILE_CONCAT(a, b) GR_PROFILE_CONCAT_(a, b)
+
+#ifdef GR_PROFILE
+#define GR_PROFILE_SCOPE_IMPL_(name, hw)                                                                  \
+    static prof::Site &GR_PROFILE_CONCAT(grProfSite_, __LINE__) = prof::site(name);                       \
+    const prof::Scope GR_PROFILE_CONCAT(grProfScope_, __LINE__)(GR_PROFILE_CONCAT(grProfSite_, __LINE__), hw)
+#define GR_PROFILE_SCOPE(name) GR_PROFILE_SCOPE_IMPL_(name, false)
+#define GR_PROFILE_PHASE(name) GR_PROFILE_SCOPE_IMPL_(name, true)
+#else
+#define GR_PROFILE_SCOPE(name) static_cast<void>(0)
+#define GR_PROFILE_PHASE(name) static_cast<void>(0)
+#endif
@@ -0,0 +1,128 @@
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include "SimpleGR.h"
+
+//@brief: quote and escape a string for JSON output
+static std::string jsonString(const std::string &s)
+{
+    std::string out = "\"";
+    for (const char c : s) {
+        switch (c) {
+        case '"':
+            out += "\\\"";
+            break;
+        case '\\':
+            out += "\\\\";
+            break;
+        case '\n':
+            out += "\\n";
+            break;
+        case '\t':
+            out += "\\t";
+            break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20) {
+                char buf[8];
+                std::snprintf(buf, sizeof(buf), "\\u%04x", static_cast<unsigned>(c));
+                out += buf;
+            } else {
+                out += c;
+            }
+        }
+    }
+    return out + "\"";
+}
+
+static void writeIterations(std::ostream &out, const std::vector<RunReport::Iteration> &iterations)
+{
+    out << "[";
+    for (std::size_t i = 0; i < iterations.size(); ++i) {
+        const RunReport::Iteration &it = iterations[i];
+        out << (i ? ",\n" : "\n") << "    {\"iteration\": " << it.iteration << ", \"nets\": " << it.netsRipped
+            << ", \"overflowing_edges\": " << it.overfullEdges << ", \"total_overflow\": " << it.totalOverflow
+            << ", \"segments\": " << it.segments << ", \"vias\": " << it.vias
+            << ", \"wire_length\": " << static_cast<CostType>(it.segments) + viaFactor * static_cast<CostType>(it.vias)
+            << ", \"wall_sec\": " << it.wallSec << "}";
+    }
+    out << (iterations.empty() ? "]" : "\n  ]");
+}
+
+//@brief: write the JSON run report requested with -report. Contains the parameters,
+//        per-phase timings, per-iteration RRR and greedy results, the final solution
+//        statistics (same numbers as printStatistics) and resource usage.
+void SimpleGR::writeReport(void)
+{
+    using namespace std;
+
+    if (params.reportFile.empty()) { return; }
+
+    ofstream out(params.reportFile.c_str());
+    if (!out.good()) {
+        cout << "Could not open `" << params.reportFile << "' for writing." << endl;
+        return;
+    }
+
+    int maxOverfill = 0;
+    for (unsigned i = 0; i < grEdgeArr.size(); ++i) {
+        maxOverfill = max(maxOverfill, grEdgeArr[i].usage - grEdgeArr[i].capacity);
+    }
+    unsigned netsRouted = 0, routedLen = 0, numVias = 0;
+    for (unsigned i = 0; i < grNetArr.size(); ++i) {
+        if (grNetArr[i].routed) {
+            ++netsRouted;
+            numVias += grNetArr[i].numVias;
+            routedLen += grNetArr[i].numSegments;
+        }
+    }
+
+    out << "{\n";
+    out << "  \"version\": " << jsonString(SimpleGRversion) << ",\n";
+    out << "  \"design\": " << jsonString(params.inputFile) << ",\n";
+    out << "  \"grid\": {\"x\": " << gcellArrSzX << ", \"y\": " << gcellArrSzY << ", \"layers\": " << numLayers
+        << ", \"nets\": " << grNetArr.size() << ", \"edges\": " << nonViaEdges << "},\n";
+    out << "  \"params\": {\"max_rip_iter\": " << params.maxRipIter << ", \"max_greedy_iter\": " << params.maxGreedyIter
+        << ", \"time_out\": " << params.timeOut << ", \"deadline\": " << params.deadline << ", \"weight\": " << params.weight
+        << ", \"tighten_weight\": " << (params.tightenWeight ? "true" : "false") << ", \"output\": " << jsonString(params.outputFile) << "},\n";
+    out << "  \"threads\": " << runReport.threads << ",\n";
+    out << "  \"pattern_routes\": " << runReport.patternRoutes << ",\n";
+    out << "  \"prior_routes_kept\": " << runReport.priorRoutesKept << ",\n";
+
+    out << "  \"phases\": [";
+    for (size_t i = 0; i < runReport.phases.size(); ++i) {
+        const RunReport::Phase &p = runReport.phases[i];
+        out << (i ? ",\n" : "\n") << "    {\"name\": " << jsonString(p.name) << ", \"wall_sec\": " << p.wallSec
+            << ", \"cpu_sec\": " << p.cpuSec << "}";
+    }
+    out << (runReport.phases.empty() ? "],\n" : "\n  ],\n");
+
+    out << "  \"searches\": [";
+    for (size_t i = 0; i < runReport.searches.size(); ++i) {
+        const RunReport::Search &search = runReport.searches[i];
+        out << (i ? ",\n" : "\n") << "    {\"phase\": " << jsonString(search.phase)
+            << ", \"iteration\": " << search.iteration << ", \"weight\": " << search.weight
+            << ", \"bounded_searches\": " << search.bound.searches << ", \"suboptimality\": " << search.bound.ratio()
+            << ", \"worst_suboptimality\": " << search.bound.worst << "}";
+    }
+    out << (runReport.searches.empty() ? "],\n" : "\n  ],\n");
+
+    out << "  \"rrr_iterations\": ";
+    writeIterations(out, runReport.rrrIterations);
+    out << ",\n  \"greedy_iterations\": ";
+    writeIterations(out, runReport.greedyIterations);
+    out << ",\n";
+
+    out << "  \"final\": {\"nets_routed\": " << netsRouted << ", \"routable_nets\": " << routableNets
+        << ", \"total_length\": " << routedLen << ", \"vias\": " << numVias
+        << ", \"wire_length\": " << static_cast<CostType>(routedLen) + viaFactor * static_cast<CostType>(numVias)
+        << ", \"overflowing_edges\": " << overfullEdges << ", \"max_overflow\": " << maxOverfill
+        << ", \"total_overflow\": " << totalOverflow << ", \"avg_overflow\": "
+        << totalOverflow / static_cast<double>(nonViaEdges) << "},\n";
+
+    out << "  \"cpu_sec\": " << cpuTime() << ",\n";
+    out << "  \"wall_sec\": " << wallTime() << ",\n";
+    out << "  \"peak_rss_kb\": " << peakRSSKb() << "\n";
+    out << "}\n";
+}
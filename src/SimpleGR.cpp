@@ -3,8 +3,11 @@
 #include <cmath>
 #include <cstdio>
 #include <iostream>
+#include <type_traits>
+#include <unordered_map>
 #include <vector>
 
+#include "Profiler.h"
 #include "SimpleGR.h"
 
 //@brief: This functor compares two nets by their bounding boxes. The one with
@@ -37,11 +40,14 @@ bool CompareByBox::operator()(const IdType a, const IdType b) const
 
 //@brief: Look for all "flat" nets, sort them from small to large
 //        and route them with a bounding box constraint
-//@param: Overflow constraint, EdgeCost functor ref
-void SimpleGR::routeFlatNets(bool allowOverflow, const EdgeCost &func)
+//@param: Overflow constraint, edge cost functor
+template<typename Cost>
+void SimpleGR::routeFlatNets(bool allowOverflow, Cost cost)
 {
     using namespace std;
 
+    GR_PROFILE_PHASE("initialRouting/flatNets");
+
     unsigned flatNetsRouted = 0;
     const bool bboxConstrain = true;
 
@@ -59,7 +65,7 @@ void SimpleGR::routeFlatNets(bool allowOverflow, const EdgeCost &func)
     sort(netIdVec.begin(), netIdVec.end(), CompareByBox(&grNetArr));
 
     // iterator over all collected nets
-    SimpleProgRpt report(static_cast<uint32_t>(netIdVec.size()));
+    SimpleProgRpt report(static_cast<uint32_t>(netIdVec.size()), params.quiet);
     for (unsigned i = 0; i < netIdVec.size(); ++i) {
         // print a simple progress report
         report.update(i);
@@ -67,6 +73,7 @@ void SimpleGR::routeFlatNets(bool allowOverflow, const EdgeCost &func)
         Net &net = grNetArr[netIdVec[i]];
 
         if (net.routed) continue;
+        if (timeUp()) break;
 
         if (params.verbose) {
             ::printf("routing flat GR net Id %d. ", net.id);
@@ -74,11 +81,11 @@ void SimpleGR::routeFlatNets(bool allowOverflow, const EdgeCost &func)
             ::printf("(%d, %d, %d) ", net.gCellTwo.x, net.gCellTwo.y, net.gCellTwo.z);
         }
         // call router engine to route net with bounding box constraint
-        CostType cost = routeNet(net, allowOverflow, bboxConstrain, func);
+        CostType routeCost = routeNet(net, allowOverflow, bboxConstrain, cost);
         if (net.routed) ++flatNetsRouted;
         if (params.verbose) {
             if (net.routed) {
-                ::printf(" routed with cost %.2f.\n", static_cast<double>(cost));
+                ::printf(" routed with cost %.2f.\n", static_cast<double>(routeCost));
             } else {
                 ::printf(" unable to route.\n");
             }
@@ -94,9 +101,21 @@ void SimpleGR::routeFlatNets(bool allowOverflow, const EdgeCost &func)
 //        routed with any path that causes overflow, or it fails to route.
 //        Bounding box constraint is soft. This function will try its best to route
 //        within the bounded area, but if that fails then it will remove the constraint.
-//@param: The net to be routed, boolean constraints: overflow and bounding box, and EdgeCost functor ref
+//@param: The net to be routed, boolean constraints: overflow and bounding box, and edge cost functor
 //@ret:   If net's routed, it returns the cost of the route. Otherwise an undefined value is returned
-CostType SimpleGR::routeNet(Net &net, bool allowOverflow, bool bboxConstrain, const EdgeCost &costfunc)
+template<typename Cost>
+CostType SimpleGR::routeNet(Net &net, bool allowOverflow, bool bboxConstrain, Cost costfunc)
+{
+    // pick the search instantiation once, so the untraced search carries no telemetry code at all
+    if (telemetry) { return routeNetImpl<Cost, SearchStats>(net, allowOverflow, bboxConstrain, costfunc); }
+    return routeNetImpl<Cost, NoSearchStats>(net, allowOverflow, bboxConstrain, costfunc);
+}
+
+template CostType SimpleGR::routeNet<UnitEdgeCost>(Net &, bool, bool, UnitEdgeCost);
+template CostType SimpleGR::routeNet<DLMEdgeCost>(Net &, bool, bool, DLMEdgeCost);
+
+template<typename Cost, typename Stats>
+CostType SimpleGR::routeNetImpl(Net &net, bool allowOverflow, bool bboxConstrain, Cost costfunc)
 {
     using namespace std;
 
@@ -105,18 +124,40 @@ CostType SimpleGR::routeNet(Net &net, bool allowOverflow, bool bboxConstrain, co
 
     routePath.clear();
 
+    // forwards a finished search to the telemetry log, a no-op for NoSearchStats
+    auto record = [&](const Stats &stats, bool bboxFallback) {
+        if constexpr (std::is_same<Stats, SearchStats>::value) {
+            telemetry->record(net, curPhase, curIteration, bboxFallback, stats, routePath.size(), totalCost);
+        } else {
+            static_cast<void>(stats);
+            static_cast<void>(bboxFallback);
+        }
+    };
+
+    // unconstrained search, the only place the overflow policy is chosen at runtime
+    auto routeWhole = [&](Stats &stats) {
+        const Point botleft(0, 0, 0);
+        const Point topright(gcellArrSzX, gcellArrSzY, 0);
+        return allowOverflow ? routeSearch<Cost, true>(net, botleft, topright, costfunc, routePath, stats)
+                             : routeSearch<Cost, false>(net, botleft, topright, costfunc, routePath, stats);
+    };
+
     if (bboxConstrain) {
         const Point botleft(min(net.gCellOne.x, net.gCellTwo.x), min(net.gCellOne.y, net.gCellTwo.y), 0);
         const Point topright(max(net.gCellOne.x, net.gCellTwo.x), max(net.gCellOne.y, net.gCellTwo.y), 0);
-        totalCost = routeMaze(net, false, botleft, topright, costfunc, routePath);
+        Stats stats;
+        totalCost = routeSearch<Cost, false>(net, botleft, topright, costfunc, routePath, stats);
+        record(stats, false);
         if (routePath.empty()) {
             // if not possible, relax the bounding box constraints to find a feasible path
-            totalCost =
-                routeMaze(net, allowOverflow, Point(0, 0, 0), Point(gcellArrSzX, gcellArrSzY, 0), costfunc, routePath);
+            Stats fallbackStats;
+            totalCost = routeWhole(fallbackStats);
+            record(fallbackStats, true);
         }
     } else {
-        totalCost =
-            routeMaze(net, allowOverflow, Point(0, 0, 0), Point(gcellArrSzX, gcellArrSzY, 0), costfunc, routePath);
+        Stats stats;
+        totalCost = routeWhole(stats);
+        record(stats, false);
     }
 
     net.routed = (routePath.size() > 0);
@@ -134,13 +175,253 @@ void SimpleGR::ripUpNet(const IdType netId)
     for (unsigned i = 0; i < net.segments.size(); ++i) { ripUpSegment(netId, net.segments[i]); }
     net.segments.clear();
     net.routed = false;
+    if (!priorRoute.empty()) { priorRoute[netId] = 0; }
+}
+
+//@brief: greedy reroute of one net without overflow. A search that gave up at the
+//        -deadline leaves the net with its old route, so greedy never loses a route.
+void SimpleGR::rerouteNet(IdType netId, UnitEdgeCost cost)
+{
+    Net &net = grNetArr[netId];
+    const std::vector<IdType> oldRoute = net.segments;
+    ripUpNet(netId);
+    routeNet(net, false, false, cost);
+    if (!net.routed) {
+        for (const IdType e : oldRoute) { addSegment(net, grEdgeArr[e]); }
+        net.routed = !net.segments.empty();
+    }
+}
+
+//@brief: route a net as an L over any edges, overflow allowed: along x then y, or y
+//        then x if the first misses an edge, each step on the nearest layer that has
+//        its edge. Without either L, one search over the whole grid with overflow that
+//        ignores the deadline.
+//@ret:   whether the net got routed
+bool SimpleGR::routePattern(Net &net)
+{
+    std::vector<Edge *> path;
+    Point cur;
+
+    // vias from the current gcell to layer z
+    auto climb = [&](CoordType z) {
+        while (cur.z != z) {
+            const GCell &cell = gcellArr3D[cur.z][cur.y][cur.x];
+            const IdType e = cur.z < z ? cell.incZ : cell.decZ;
+            if (e == NULLID) { return false; }
+            path.push_back(&grEdgeArr[e]);
+            cur.z = cur.z < z ? cur.z + 1 : cur.z - 1;
+        }
+        return true;
+    };
+    auto stepEdge = [&](CoordType z, bool alongX, bool up) {
+        const GCell &cell = gcellArr3D[z][cur.y][cur.x];
+        return alongX ? (up ? cell.incX : cell.decX) : (up ? cell.incY : cell.decY);
+    };
+    // straight to `to` along x or y
+    auto run = [&](bool alongX, CoordType to) {
+        CoordType &at = alongX ? cur.x : cur.y;
+        while (at != to) {
+            const bool up = at < to;
+            CoordType layer = NULLID;
+            for (CoordType d = 0; d < numLayers && layer == NULLID; ++d) {
+                if (cur.z + d < numLayers && stepEdge(cur.z + d, alongX, up) != NULLID) {
+                    layer = cur.z + d;
+                } else if (d <= cur.z && stepEdge(cur.z - d, alongX, up) != NULLID) {
+                    layer = cur.z - d;
+                }
+            }
+            if (layer == NULLID || !climb(layer)) { return false; }
+            path.push_back(&grEdgeArr[stepEdge(layer, alongX, up)]);
+            at = up ? at + 1 : at - 1;
+        }
+        return true;
+    };
+    auto walk = [&](bool xFirst) {
+        path.clear();
+        cur = net.gCellOne;
+        const Point &to = net.gCellTwo;
+        return run(xFirst, xFirst ? to.x : to.y) && run(!xFirst, xFirst ? to.y : to.x) && climb(to.z);
+    };
+
+    if (!walk(true) && !walk(false)) {
+        path.clear();
+        searchDeadline = false;
+        NoSearchStats stats;
+        routeMaze<DLMEdgeCost, true>(
+            net, Point(0, 0, 0), Point(gcellArrSzX, gcellArrSzY, 0), DLMEdgeCost(*this), path, stats);
+        searchDeadline = params.deadline > 0.;
+    }
+
+    for (Edge *edge : path) { addSegment(net, *edge); }
+    net.routed = !path.empty();
+    return net.routed;
+}
+
+//@brief: once the -deadline has passed, give every net still unrouted a pattern route,
+//        so the phase ends with a complete solution
+void SimpleGR::routeRemaining(const char *phase)
+{
+    using namespace std;
+
+    unsigned routed = 0, failed = 0;
+    for (Net &net : grNetArr) {
+        if (net.routed) { continue; }
+        if (routePattern(net)) {
+            ++routed;
+        } else {
+            ++failed;
+        }
+    }
+    if (routed + failed == 0) { return; }
+    runReport.patternRoutes += routed;
+    cout << "Deadline reached during " << phase << ", " << routed << " GR nets pattern routed";
+    if (failed > 0) { cout << ", " << failed << " left unrouted"; }
+    cout << endl;
+}
+
+// smallest group worth a shortest-path tree; below it separate A* searches are cheaper
+static constexpr std::size_t minTreeGroup = 8;
+
+// nets per parallel greedy batch, independent of the thread count so that any number
+// of threads gives the same routes
+static constexpr std::size_t greedyBatchSize = 256;
+
+//@brief: Group the nets that share a pin gcell. Each net joins the group of whichever
+//        of its pins is shared by more nets; only groups of at least minTreeGroup nets
+//        are returned, each with its shared pin gcell in `sources`.
+std::vector<std::vector<IdType>> SimpleGR::groupBySharedPin(const std::vector<IdType> &netIds,
+    std::vector<IdType> &sources) const
+{
+    using namespace std;
+
+    auto pinId = [this](const Point &p) { return gcellCoordToId(p.x, p.y, p.z); };
+
+    unordered_map<IdType, unsigned> pinCount;
+    for (const IdType id : netIds) {
+        const Net &net = grNetArr[id];
+        ++pinCount[pinId(net.gCellOne)];
+        if (!(net.gCellTwo == net.gCellOne)) { ++pinCount[pinId(net.gCellTwo)]; }
+    }
+
+    unordered_map<IdType, vector<IdType>> bySource;
+    vector<IdType> order;// sources in order of first appearance, for a deterministic result
+    for (const IdType id : netIds) {
+        const Net &net = grNetArr[id];
+        const IdType one = pinId(net.gCellOne), two = pinId(net.gCellTwo);
+        const IdType source = pinCount[one] >= pinCount[two] ? one : two;
+        vector<IdType> &group = bySource[source];
+        if (group.empty()) { order.push_back(source); }
+        group.push_back(id);
+    }
+
+    vector<vector<IdType>> groups;
+    sources.clear();
+    for (const IdType source : order) {
+        vector<IdType> &group = bySource[source];
+        if (group.size() < minTreeGroup) { continue; }
+        groups.push_back(std::move(group));
+        sources.push_back(source);
+    }
+    return groups;
+}
+
+//@brief: Route a group of nets sharing the pin gcell `sourceId` from one shortest-path
+//        tree, under the constraints of the first search routeNet would run. Tree
+//        routes are committed in order while they still fit, stay in their net's own
+//        bounding box when it is constrained, and cost at most (1 + staleness) times
+//        their cost in the tree; during initial routing usage only grows, so that is
+//        also the bound on their suboptimality. Any other net goes through routeNet.
+//        With `ripUpFirst` each net is ripped up right before its turn, as greedy
+//        improvement does, takes its tree route only if that costs no more than its
+//        old route, and keeps its old route if routeNet fails.
+//@ret:   number of nets routed from the tree
+template<typename Cost>
+unsigned SimpleGR::routeGroup(IdType sourceId,
+    const std::vector<IdType> &netIds,
+    bool allowOverflow,
+    bool bboxConstrain,
+    bool ripUpFirst,
+    Cost cost)
+{
+    using namespace std;
+
+    thread_local vector<vector<Edge *>> paths;
+    thread_local vector<CostType> costs;
+
+    vector<IdType> targets;
+    const Point source = gcellIdtoCoord(sourceId);
+    Point botleft(source.x, source.y, 0), topright(source.x, source.y, 0);
+    for (const IdType id : netIds) {
+        const Net &net = grNetArr[id];
+        const Point &target = net.gCellOne == source ? net.gCellTwo : net.gCellOne;
+        targets.push_back(gcellCoordToId(target.x, target.y, target.z));
+        botleft = Point(min(botleft.x, target.x), min(botleft.y, target.y), 0);
+        topright = Point(max(topright.x, target.x), max(topright.y, target.y), 0);
+    }
+
+    // a bounding box constrained route first tries the box without overflow
+    const bool treeOverflow = !bboxConstrain && allowOverflow;
+    if (bboxConstrain) {
+        routeTree<Cost, false>(sourceId, targets, botleft, topright, cost, paths, costs);
+    } else if (allowOverflow) {
+        routeTree<Cost, true>(sourceId, targets, Point(0, 0, 0), Point(gcellArrSzX, gcellArrSzY, 0), cost, paths, costs);
+    } else {
+        routeTree<Cost, false>(sourceId, targets, Point(0, 0, 0), Point(gcellArrSzX, gcellArrSzY, 0), cost, paths, costs);
+    }
+
+    unsigned fromTree = 0;
+    for (size_t i = 0; i < netIds.size(); ++i) {
+        Net &net = grNetArr[netIds[i]];
+        const vector<IdType> oldRoute = ripUpFirst ? net.segments : vector<IdType>();
+        if (ripUpFirst) { ripUpNet(netIds[i]); }
+
+        const Point low(min(net.gCellOne.x, net.gCellTwo.x), min(net.gCellOne.y, net.gCellTwo.y), 0);
+        const Point high(max(net.gCellOne.x, net.gCellTwo.x), max(net.gCellOne.y, net.gCellTwo.y), 0);
+        auto inBox = [&](const GCell *cell) {
+            return low.x <= cell->x && cell->x <= high.x && low.y <= cell->y && cell->y <= high.y;
+        };
+
+        bool fresh = !paths[i].empty();
+        CostType current = 0.f;
+        for (const Edge *edge : paths[i]) {
+            if (!treeOverflow && !edgeHasRoom(*edge)) { fresh = false; }
+            if (bboxConstrain && !(inBox(edge->gcell1) && inBox(edge->gcell2))) { fresh = false; }
+            current += cost(edge->id);
+        }
+
+        // the tree was grown around this net's old route, which may have kept it off
+        // cheaper edges: a rerouted net never takes a tree route longer than the old one
+        CostType bound = costs[i] * static_cast<CostType>(1. + params.staleness);
+        if (!oldRoute.empty()) {
+            CostType oldCost = 0.f;
+            for (const IdType e : oldRoute) { oldCost += cost(e); }
+            bound = min(bound, oldCost);
+        }
+
+        if (fresh && current <= bound) {
+            for (Edge *edge : paths[i]) { addSegment(net, *edge); }
+            net.routed = true;
+            ++fromTree;
+        } else {
+            routeNet(net, allowOverflow, bboxConstrain, cost);
+            // a search that gave up at the deadline leaves a ripped up net its old route
+            if (!net.routed && !oldRoute.empty()) {
+                for (const IdType e : oldRoute) { addSegment(net, grEdgeArr[e]); }
+                net.routed = true;
+            }
+        }
+    }
+    return fromTree;
 }
 
 //@brief: Process nets in a bulk mode: Collect unrouted nets, sort them, and route them
-void SimpleGR::routeNets(bool allowOverflow, const EdgeCost &func)
+template<typename Cost>
+void SimpleGR::routeNets(bool allowOverflow, Cost cost)
 {
     using namespace std;
 
+    GR_PROFILE_PHASE("initialRouting/routeNets");
+
     vector<IdType> netIdVec;
     for (unsigned i = 0; i < grNetArr.size(); ++i) {
         if (!grNetArr[i].routed) { netIdVec.push_back(i); }
@@ -150,37 +431,170 @@ void SimpleGR::routeNets(bool allowOverflow, const EdgeCost &func)
 
     bool bboxConstrain = true;
 
-    SimpleProgRpt report(netIdVec.size());
+    // with -shareSource, a group of nets sharing a pin is routed when its first net comes up
+    vector<IdType> sources;
+    const vector<vector<IdType>> groups = params.shareSource ? groupBySharedPin(netIdVec, sources)
+                                                             : vector<vector<IdType>>();
+    vector<IdType> groupOf(grNetArr.size(), NULLID);
+    for (IdType g = 0; g < groups.size(); ++g) {
+        for (const IdType id : groups[g]) { groupOf[id] = g; }
+    }
+    vector<char> groupDone(groups.size(), false);
+    unsigned fromTrees = 0;
+
+    SimpleProgRpt report(netIdVec.size(), params.quiet);
     unsigned routedNets = 0;
     for (unsigned i = 0; i < netIdVec.size(); ++i) {
         Net &net = grNetArr[netIdVec[i]];
         report.update(i);
 
         if (net.routed) continue;
+        if (timeUp()) break;
+
+        const IdType g = groupOf[netIdVec[i]];
+        if (g != NULLID) {
+            if (!groupDone[g]) {
+                groupDone[g] = true;
+                fromTrees += routeGroup(sources[g], groups[g], allowOverflow, bboxConstrain, false, cost);
+                for (const IdType id : groups[g]) {
+                    if (grNetArr[id].routed) { routedNets++; }
+                }
+            }
+            continue;
+        }
 
-        routeNet(net, allowOverflow, bboxConstrain, func);
+        routeNet(net, allowOverflow, bboxConstrain, cost);
         if (net.routed) { routedNets++; }
     }
     cout << "routed " << routedNets << " GR nets" << endl;
+    if (params.shareSource) { cout << fromTrees << " of them from " << groups.size() << " shared source trees" << endl; }
 }
 
 
+//@brief: set the weighted A* inflation factor for the searches that follow
+void SimpleGR::beginSearches(double weight)
+{
+    searchWeight = static_cast<CostType>(std::max(1., weight));
+    searchBound = SearchBound();
+}
+
+//@brief: record the suboptimality achieved since beginSearches, and print it
+//        when the heuristic was actually inflated, along with the route cache hits
+void SimpleGR::endSearches(const char *phase, unsigned iteration)
+{
+    runReport.searches.push_back(
+        RunReport::Search{ phase, iteration, static_cast<double>(searchWeight), searchBound });
+    if (searchWeight > 1.f) {
+        std::cout << "weighted A* (w = " << searchWeight << "): route cost within " << searchBound.ratio()
+                  << "x of optimal, worst net " << searchBound.worst << "x" << std::endl;
+    }
+    if (routeCache.enabled()) {
+        std::cout << "route cache: " << routeCache.hits << " of " << routeCache.hits + routeCache.misses
+                  << " searches reused" << std::endl;
+        routeCache.hits = routeCache.misses = 0;
+    }
+    searchWeight = 1.f;
+}
+
+//@brief: give every search thread beyond the main one its own queue and bound
+void SimpleGR::prepareWorkers(unsigned threads)
+{
+    workerQueues.resize(threads - 1);
+    for (PQueue &queue : workerQueues) { queue.resize(numLayers * gcellArrSzX * gcellArrSzY); }
+    workerBounds.assign(threads - 1, SearchBound());
+    workerScratch.resize(threads - 1);
+}
+
+//@brief: Greedy reroute of a batch of nets with the searches run in parallel. All nets
+//        are ripped up and then searched against the same grid. The routes are committed
+//        in order, each only if it still fits without overflow next to the routes already
+//        committed while leaving room for the old routes of the nets still to come
+//        (`reserved`, all zero between calls). A net whose route does not fit gets its old
+//        route back and is rerouted on its own afterwards, as the serial loop would.
+//        Returns the number of such nets.
+template<typename Stats>
+unsigned SimpleGR::routeBatch(const std::vector<IdType> &netIds, UnitEdgeCost cost, std::vector<CapType> &reserved)
+{
+    using namespace std;
+
+    GR_PROFILE_SCOPE("routeBatch");
+
+    auto demand = [this](const Edge &edge) -> CapType {
+        return edge.type == VIA ? 0 : minWidths[edge.layer] + minSpacings[edge.layer];
+    };
+
+    vector<vector<IdType>> oldRoutes(netIds.size());
+    for (size_t k = 0; k < netIds.size(); ++k) {
+        oldRoutes[k] = grNetArr[netIds[k]].segments;
+        for (const IdType e : oldRoutes[k]) { reserved[e] += demand(grEdgeArr[e]); }
+        ripUpNet(netIds[k]);
+    }
+
+    // the grid is read-only until every search is done
+    vector<vector<Edge *>> paths(netIds.size());
+    vector<CostType> costs(netIds.size());
+    vector<Stats> stats(netIds.size());
+    const Point botleft(0, 0, 0);
+    const Point topright(gcellArrSzX, gcellArrSzY, 0);
+    parallelFor(netIds.size(), static_cast<unsigned>(workerQueues.size() + 1), [&](size_t k, unsigned worker) {
+        searchWorker = worker;
+        searchShared = true;
+        costs[k] = routeSearch<UnitEdgeCost, false>(grNetArr[netIds[k]], botleft, topright, cost, paths[k], stats[k]);
+    });
+    searchShared = false;
+    for (SearchBound &bound : workerBounds) {
+        searchBound.merge(bound);
+        bound = SearchBound();
+    }
+
+    vector<IdType> retry;
+    for (size_t k = 0; k < netIds.size(); ++k) {
+        Net &net = grNetArr[netIds[k]];
+        for (const IdType e : oldRoutes[k]) { reserved[e] -= demand(grEdgeArr[e]); }
+        if constexpr (std::is_same<Stats, SearchStats>::value) {
+            telemetry->record(net, curPhase, curIteration, false, stats[k], paths[k].size(), costs[k]);
+        }
+
+        bool fits = !paths[k].empty();
+        for (const Edge *edge : paths[k]) {
+            fits = fits && edge->usage + demand(*edge) + reserved[edge->id] <= edge->capacity;
+        }
+        if (fits) {
+            for (Edge *edge : paths[k]) { addSegment(net, *edge); }
+        } else {
+            for (const IdType e : oldRoutes[k]) { addSegment(net, grEdgeArr[e]); }
+            retry.push_back(netIds[k]);
+        }
+        net.routed = !net.segments.empty();
+    }
+
+    for (const IdType id : retry) { rerouteNet(id, cost); }
+    return static_cast<unsigned>(retry.size());
+}
+
 //@brief: use iterative rip-up and re-route scheme to improve QoR of all nets.
 void SimpleGR::doRRR(void)
 {
     using namespace std;
 
     if (params.maxRipIter == 0) return;
+    if (resumed.rrrDone) {
+        cout << "Rip-up and re-route had ended in the checkpoint, skipping" << endl;
+        return;
+    }
+
+    GR_PROFILE_PHASE("doRRR");
+    const ScopedPhase phase(runReport, "doRRR");
 
     vector<IdType> netsToRip;
-    unsigned iterations = 1;
-    EdgeCost &dlm = EdgeCost::getFunc(this);
-    dlm.setType(EdgeCost::DLMCost);
+    unsigned iterations = resumed.iteration + 1;
+    const DLMEdgeCost dlm(*this);
 
     cout << "[Iterative Rip-up and Re-Route starts]" << endl;
     cout << "Performing at most " << params.maxRipIter << " rip-up and re-route iteration(s)" << endl;
 
-    double startCPU = cpuTime();
+    // a resumed run continues the -timeOut budget of the one it resumes
+    double startCPU = cpuTime() - resumed.rrrCpuSec;
 
     const bool bboxConstrain = true;
     const bool nobboxConstrain = false;
@@ -189,6 +603,14 @@ void SimpleGR::doRRR(void)
 
     // outer RRR loop, each loop is one RRR iteration
     while (true) {
+        if (resumed.iteration > 0 && iterations >= params.maxRipIter) {
+            cout << "Iterations exceeded, quitting" << endl;
+            break;
+        }
+        if (timeUp()) {
+            cout << "Deadline reached, quitting" << endl;
+            break;
+        }
         // Start collecting unrouted nets
         for (unsigned i = 0; i < grNetArr.size(); ++i) {
             if (!grNetArr[i].routed) { netsToRip.push_back(i); }
@@ -199,9 +621,10 @@ void SimpleGR::doRRR(void)
             if (grEdgeArr[i].usage > grEdgeArr[i].capacity) {
                 netsToRip.insert(netsToRip.end(), grEdgeArr[i].nets.begin(), grEdgeArr[i].nets.end());
                 // overflow edge's history cost increments in each iteration.
-                // The history cost is used by the DLM EdgeCost functor
+                // The history cost is used by the DLM edge cost functor
                 // to heavily penalize edges that repeatedly overflow
                 grEdgeArr[i].historyCost += historyIncrement;
+                routeCache.touchHistory(grEdgeArr[i]);
             }
         }
         // get rid of the duplicated nets in the queue
@@ -215,18 +638,31 @@ void SimpleGR::doRRR(void)
             cout << "No more GR nets to rip up, quitting" << endl;
             break;
         }
+        // tighten the A* heuristic with the new history costs
+        refreshDLMBound(netsToRip);
+        // relabel the components, dropping connections lost to saturated edges
+        buildComponents(true);
         cout << endl;
         cout << "RRR Iteration " << iterations << " starts" << endl;
         cout << "number of GR nets that need to be ripped up: " << netsToRip.size() << endl;
+        curPhase = RRRPhase;
+        curIteration = iterations;
+        // with -tightenWeight the excess weight halves in every iteration
+        beginSearches(params.tightenWeight ? 1. + (params.weight - 1.) / (1U << min(iterations, 30U)) : params.weight);
 
         // inner RRR loop, each loop rips up and reroutes a net.
-        SimpleProgRpt report(netsToRip.size());
+        GR_PROFILE_PHASE("doRRR/iteration");
+        const double iterStart = wallTime();
+        SimpleProgRpt report(netsToRip.size(), params.quiet);
         for (unsigned i = 0; i < netsToRip.size(); ++i) {
             report.update(i);
 
             const IdType netId = netsToRip[i];
             Net &net = grNetArr[netId];
 
+            // out of time, the nets left keep their routes
+            if (timeUp()) break;
+
             // rip up the net
             ripUpNet(netId);
 
@@ -246,12 +682,26 @@ void SimpleGR::doRRR(void)
             if (overfullEdges == 0) break;
         }
 
+        runReport.rrrIterations.push_back(RunReport::Iteration{ iterations,
+            netsToRip.size(),
+            overfullEdges,
+            totalOverflow,
+            totalSegments,
+            totalVias,
+            wallTime() - iterStart });
+        endSearches("doRRR", iterations);
+
         netsToRip.clear();
         cout << "RRR iteration " << iterations << " ends" << endl;
         ++iterations;
 
         printStatisticsLight();
+        writeCongestionFrame(iterations - 1);
+        reportProgress("doRRR", iterations - 1);
         double cpuTimeUsed = cpuTime();
+        if ((iterations - 1) % max(1U, params.checkpointEvery) == 0) {
+            saveCheckpoint(iterations - 1, false, cpuTimeUsed - startCPU);
+        }
 
         if (iterations >= params.maxRipIter) {
             cout << "Iterations exceeded, quitting" << endl;
@@ -262,9 +712,45 @@ void SimpleGR::doRRR(void)
             break;
         }
     }
+    // a net whose search was cut short is routed again as a pattern
+    if (timeUp()) { routeRemaining("rip-up and re-route"); }
+    saveCheckpoint(iterations - 1, true, cpuTime() - startCPU);
+    checkpointWriter.wait();
+    writeCongestionMaps("doRRR");
+    reportProgress("doRRR", 0);
     cout << "[Iterative Rip-up and Re-Route ends]" << endl;
 }
 
+//@brief: rip up and re-route the given GR nets the way a rip-up and re-route iteration
+//        does, smallest bounding box first: without overflow if possible, with it
+//        otherwise. For queries on a routed design, e.g. from grserver.
+void SimpleGR::rerouteNets(std::vector<IdType> netIds)
+{
+    using namespace std;
+
+    GR_PROFILE_PHASE("rerouteNets");
+    const ScopedPhase phase(runReport, "rerouteNets");
+    runStart = wallTime();
+
+    sort(netIds.begin(), netIds.end());
+    netIds.erase(unique(netIds.begin(), netIds.end()), netIds.end());
+    sort(netIds.begin(), netIds.end(), CompareByBox(&grNetArr));
+
+    const DLMEdgeCost dlm(*this);
+    refreshDLMBound(netIds);
+    buildComponents(true);
+    curPhase = RRRPhase;
+    beginSearches(params.weight);
+    for (const IdType netId : netIds) {
+        Net &net = grNetArr[netId];
+        ripUpNet(netId);
+        routeNet(net, false, false, dlm);
+        if (!net.routed) { routeNet(net, true, false, dlm); }
+    }
+    endSearches("rerouteNets", 0);
+    cout << "rerouted " << netIds.size() << " GR net(s)" << endl;
+}
+
 //@brief: Route all nets one by one in a wire length greedy mode.
 void SimpleGR::greedyImprovement(void)
 {
@@ -274,60 +760,192 @@ void SimpleGR::greedyImprovement(void)
         cout << "Warning: skipping greedy improvement due to overflowing solution" << endl;
         return;
     }
+    if (timeUp()) {
+        cout << "Warning: skipping greedy improvement, deadline reached" << endl;
+        return;
+    }
+
+    GR_PROFILE_PHASE("greedyImprovement");
+    const ScopedPhase phase(runReport, "greedyImprovement");
 
     cout << "[Greedy improvement routing starts]" << endl;
 
-    // Since we want to get greedy with wire length, we use the unit cost function
-    EdgeCost &uc = EdgeCost::getFunc(this);
-    uc.setType(EdgeCost::UnitCost);
+    // Since we want to get greedy with wire length, we use the unit cost function,
+    // searched by the bit-parallel wavefront
+    const UnitEdgeCost uc(*this);
+    buildComponents(true);
+    buildWavefront();
 
     const bool donotallowOverflow = false;
     const bool noBBoxConstrain = false;
 
+    // with -warmStart, the nets kept on their prior routes were improved by the prior run
     vector<IdType> netArray;
-    for (unsigned i = 0; i < grNetArr.size(); ++i) { netArray.push_back(i); }
+    for (unsigned i = 0; i < grNetArr.size(); ++i) {
+        if (priorRoute.empty() || !priorRoute[i]) { netArray.push_back(i); }
+    }
+    if (!priorRoute.empty()) {
+        cout << "keeping the prior routes of " << grNetArr.size() - netArray.size() << " GR nets" << endl;
+    }
     sort(netArray.begin(), netArray.end(), CompareByBox(&grNetArr));
 
+    vector<IdType> sources;
+    const vector<vector<IdType>> groups = params.shareSource ? groupBySharedPin(netArray, sources)
+                                                             : vector<vector<IdType>>();
+
     cout << "performing " << params.maxGreedyIter << " greedy improvement iteration(s)" << endl;
 
+    // with more than one thread, nets are rerouted in batches searched in parallel
+    const unsigned threads = resolveThreads(params.threads);
+    if (threads > 1) { prepareWorkers(threads); }
+    vector<CapType> reserved(threads > 1 ? grEdgeArr.size() : 0, 0);
+    vector<IdType> batch;
+    unsigned batchRetries = 0;
+    auto flushBatch = [&]() {
+        if (batch.empty()) { return; }
+        batchRetries += telemetry ? routeBatch<SearchStats>(batch, uc, reserved)
+                                  : routeBatch<NoSearchStats>(batch, uc, reserved);
+        batch.clear();
+    };
+
+    vector<IdType> groupOf(grNetArr.size(), NULLID);
+    for (IdType g = 0; g < groups.size(); ++g) {
+        for (const IdType id : groups[g]) { groupOf[id] = g; }
+    }
+
     for (unsigned iterations = 1; iterations <= params.maxGreedyIter; ++iterations) {
-        cout << endl << "examining " << netArray.size() << " GR nets " << endl;
-        SimpleProgRpt report(netArray.size());
-        for (unsigned i = 0; i < netArray.size(); ++i) {
+        if (timeUp()) {
+            cout << "Deadline reached, quitting" << endl;
+            break;
+        }
+        // A net routed at its unit cost lower bound (Manhattan distance with the fewest
+        // vias its pin layers allow) cannot improve; grouped nets go with their tree
+        vector<IdType> candidates;
+        candidates.reserve(netArray.size());
+        for (const IdType id : netArray) {
+            const Net &net = grNetArr[id];
+            const CostType routeCost = static_cast<CostType>(net.numSegments) * edgeBase
+                                       + static_cast<CostType>(net.numVias) * viaCost();
+            if (groupOf[id] == NULLID && net.routed && routeCost <= unitBound(net.gCellOne, net.gCellTwo)) {
+                continue;
+            }
+            candidates.push_back(id);
+        }
+        cout << endl
+             << "examining " << candidates.size() << " GR nets, skipping " << netArray.size() - candidates.size()
+             << " already optimal" << endl;
+        curPhase = GreedyPhase;
+        curIteration = iterations;
+        // greedy improvement is exact when tightening
+        beginSearches(params.tightenWeight ? 1. : params.weight);
+        const double iterStart = wallTime();
+        vector<char> groupDone(groups.size(), false);
+        unsigned fromTrees = 0;
+        batchRetries = 0;
+
+        SimpleProgRpt report(candidates.size(), params.quiet);
+        for (unsigned i = 0; i < candidates.size(); ++i) {
             report.update(i);
-            Net &net = grNetArr[netArray[i]];
-            // Rip-up only this one net
-            ripUpNet(netArray[i]);
-            // We now know there is at least one path that the net can be routed without overflow,
-            // so we can safely turn on overflow constraint for the router.
-            routeNet(net, donotallowOverflow, noBBoxConstrain, uc);
+            // out of time, the nets left keep their routes
+            if (timeUp()) {
+                cout << "Deadline reached after " << i << " of " << candidates.size() << " GR nets" << endl;
+                break;
+            }
+            const IdType g = groupOf[candidates[i]];
+            if (g != NULLID) {
+                // every net of the group is ripped up just before it is rerouted
+                if (!groupDone[g]) {
+                    groupDone[g] = true;
+                    flushBatch();
+                    fromTrees += routeGroup(sources[g], groups[g], donotallowOverflow, noBBoxConstrain, true, uc);
+                }
+                continue;
+            }
+            if (threads > 1) {
+                batch.push_back(candidates[i]);
+                if (batch.size() == greedyBatchSize) { flushBatch(); }
+                continue;
+            }
+            // Rip-up only this one net. We now know there is at least one path that the net
+            // can be routed without overflow, so we can safely turn on overflow constraint
+            // for the router.
+            rerouteNet(candidates[i], uc);
+        }
+        flushBatch();
+        if (params.shareSource) {
+            cout << fromTrees << " GR nets rerouted from " << groups.size() << " shared source trees" << endl;
         }
+        if (threads > 1) { cout << batchRetries << " GR nets rerouted again after a batch conflict" << endl; }
+        runReport.greedyIterations.push_back(RunReport::Iteration{ iterations,
+            candidates.size(),
+            overfullEdges,
+            totalOverflow,
+            totalSegments,
+            totalVias,
+            wallTime() - iterStart });
+        endSearches("greedyImprovement", iterations);
         cout << "after greedy improvement iteration " << iterations << endl;
         printStatisticsLight();
     }
+    writeCongestionMaps("greedyImprovement");
+    reportProgress("greedyImprovement", 0);
     cout << "[Greedy improvement routing ends]" << endl;
 }
 
-//@brief: Initial route all nets with minimum effort.
-void SimpleGR::initialRouting(void)
+//@brief: Initial route all nets with minimum effort. False if the checkpoint of -resume
+//        or the solution of -warmStart could not be read, with the reason in parseError().
+bool SimpleGR::initialRouting(void)
 {
     using namespace std;
 
+    GR_PROFILE_PHASE("initialRouting");
+    const ScopedPhase phase(runReport, "initialRouting");
+    runStart = wallTime();
+
+    if (!params.resumeFile.empty()) {
+        cout << "[Resuming from checkpoint `" << params.resumeFile << "']" << endl;
+        if (!loadCheckpoint()) { return false; }
+        buildComponents(false);
+        buildComponents(true);
+        cout << "Restored routes after " << resumed.iteration << " RRR iteration(s)" << endl;
+        writeCongestionMaps("initialRouting");
+        reportProgress("initialRouting", 0);
+        return true;
+    }
+
     cout << "[Initial routing starts]" << endl;
 
+    // with -warmStart only the nets without a usable prior route are routed below
+    if (!params.warmStartFile.empty() && !warmStart()) { return false; }
+
     // We want the initial route to be congestion aware, hence
     // use the DLMCost function.
-    EdgeCost &dlm = EdgeCost::getFunc(this);
-    dlm.setType(EdgeCost::DLMCost);
+    const DLMEdgeCost dlm(*this);
+
+    beginSearches(params.weight);
+    // initial routing only adds usage, so the current grid bounds every later search
+    refreshDLMBound(vector<IdType>());
+    buildComponents(false);
+    buildComponents(true);
 
     cout << "phase 1. routing flat GR nets" << endl;
+    curPhase = FlatPhase;
+    curIteration = 0;
     const bool donotallowOverflow = false;
     routeFlatNets(donotallowOverflow, dlm);
     cout << "CPU time: " << cpuTime() << " seconds " << endl;
 
     cout << "phase 2. routing remaining GR nets" << endl;
+    curPhase = BulkPhase;
     const bool allowOverflow = true;
+    refreshDLMBound(vector<IdType>());
     routeNets(allowOverflow, dlm);
+    endSearches("initialRouting", 0);
+    if (timeUp()) { routeRemaining("initial routing"); }
+    saveCheckpoint(0, params.maxRipIter == 0, 0.);
+    writeCongestionMaps("initialRouting");
+    reportProgress("initialRouting", 0);
 
     cout << "[Initial routing ends]" << endl;
+    return true;
 }
@@ -1,17 +1,28 @@
 #ifndef _SIMPLEGR_H_
 #define _SIMPLEGR_H_
 
+#include "Parallel.h"
 #include "detail.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <charconv>
+#include <chrono>
 #include <cmath>
 #include <cstring>
+#include <fstream>
+#include <functional>
 #include <iostream>
 #include <limits>
-#include <map>
+#include <memory>
 #include <stdint.h>
 #include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 using CoordType = uint32_t;
@@ -32,6 +43,15 @@ static constexpr CapType NULLCAP = std::numeric_limits<CapType>::max();
 
 const std::string SimpleGRversion = "1.1";
 
+//@brief: A simple CPU timer API
+double cpuTime(void);
+//@brief: Wall clock seconds since the process started
+double wallTime(void);
+//@brief: Peak resident set size of the process in kilobytes
+long peakRSSKb(void);
+//@brief: 64-bit FNV-1a hash of `size` bytes, of net names and of checkpoint files
+uint64_t fnv1a(const char *data, std::size_t size);
+
 class Point
 {
   public:
@@ -84,6 +104,202 @@ class Net
     {}
 };
 
+//@brief: Net names interned back to back in one character array, with an open
+//        addressing hash table (linear probing, at most half full) from a name to its
+//        entry. Names are added while parsing and the table is built once at the end;
+//        a repeated name maps to its last entry. Each entry carries a net ID, NULLID
+//        for nets that are not routed (both pins in one gcell).
+class NetNameIndex
+{
+  public:
+    // entries are numbered in the order they are added
+    IdType add(std::string_view name, IdType netId);
+    void build(void);
+    // false if the name is unknown, otherwise sets netId to the entry's net ID
+    bool find(std::string_view name, IdType &netId) const;
+
+    std::string_view name(IdType entry) const
+    {
+        return std::string_view(chars_.data() + begin_[entry], begin_[entry + 1] - begin_[entry]);
+    }
+    IdType size(void) const { return static_cast<IdType>(netIds_.size()); }
+
+  private:
+    std::string chars_;
+    std::vector<std::size_t> begin_{ 0 };// entry i is chars_[begin_[i], begin_[i + 1])
+    std::vector<IdType> netIds_;
+    std::vector<uint32_t> hashes_;
+    // entry + 1 per slot, 0 if empty; the low bits of the name hash pick the first slot
+    std::vector<IdType> slots_;
+
+    static uint32_t hash(std::string_view name);
+};
+
+//@brief: a file mapped read-only into memory, or read into a buffer where it cannot be
+//        mapped
+class MappedFile
+{
+  public:
+    MappedFile() = default;
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+    ~MappedFile();
+
+    bool open(const char *filename);
+    std::string_view text(void) const { return std::string_view(data_, size_); }
+
+  private:
+    const char *data_{ nullptr };
+    std::size_t size_{ 0 };
+    bool mapped_{ false };
+    std::string buffer_;
+};
+
+//@brief: reads the words and numbers of a design or solution file like an ifstream
+//        does with >>, from a buffer refilled in large blocks (or from text already in
+//        memory) and with std::from_chars for the numbers. Reading past the end makes
+//        good() false, while something else where a number is expected is a parsing
+//        error that ends the process, unless the scanner is not fatal.
+class TextScanner
+{
+  public:
+    TextScanner() = default;
+    explicit TextScanner(std::string_view text) : data_(text.data()), end_(text.size()), eof_(true) {}
+
+    bool open(const char *filename);
+    bool good(void) const { return !failed_; }
+    // scan other text in memory, from a good state
+    void reset(std::string_view text)
+    {
+        data_ = text.data();
+        pos_ = 0;
+        end_ = text.size();
+        eof_ = true;
+        failed_ = false;
+        error_.clear();
+    }
+    // when not fatal, a bad number only makes good() false and error() says what it was
+    void setFatal(bool fatal) { fatal_ = fatal; }
+    const std::string &error(void) const { return error_; }
+
+    // next character without skipping whitespace, '\0' at the end of the file
+    char peek(void);
+    // skip past the end of the current line
+    void skipLine(void);
+    // next whitespace-separated word, valid until the next read; empty at the end
+    std::string_view word(void);
+    // rest of the current line without its newline, valid until the next read
+    std::string_view line(void);
+
+    TextScanner &operator>>(std::string &value);
+    TextScanner &operator>>(char &value);
+    template<typename T> TextScanner &operator>>(T &value)
+    {
+        skipSpace();
+        if (end_ - pos_ < maxNumberLength) { fill(); }
+        const char *first = data_ + pos_;
+        const std::from_chars_result result = std::from_chars(first, data_ + end_, value);
+        if (result.ec != std::errc()) {
+            badNumber();
+        } else {
+            pos_ += static_cast<std::size_t>(result.ptr - first);
+        }
+        return *this;
+    }
+
+  private:
+    static constexpr std::size_t blockSize = 1 << 20;
+    static constexpr std::size_t maxNumberLength = 64;
+
+    static bool isSpace(char c) { return c == ' ' || c == '\n' || c == '\t' || c == '\r' || c == '\v' || c == '\f'; }
+    // move the unread characters to the front and read more; false if there are none
+    bool fill(void);
+    void skipSpace(void);
+    void badNumber(void);
+
+    std::ifstream file_;
+    std::vector<char> buffer_;
+    const char *data_{ nullptr };
+    std::size_t pos_{ 0 }, end_{ 0 };// unread characters are data_[pos_, end_)
+    bool eof_{ false }, failed_{ false }, fatal_{ true };
+    std::string error_;
+};
+
+//@brief: scratch space of SimpleGR::routeConnects, reused between calls
+class RouteScratch
+{
+  public:
+    std::vector<IdType> ends, cells, parent, degree;
+};
+
+//@brief: totals of the routing, as printStatistics prints them
+class RouteStatistics
+{
+  public:
+    IdType netsRouted{ 0 }, routableNets{ 0 };
+    // wire edges and vias of the routed nets, and their wire length with a via counted
+    // as viaFactor wires
+    unsigned routedLength{ 0 }, vias{ 0 };
+    CostType wireLength{ 0 };
+    unsigned overfullEdges{ 0 }, totalOverflow{ 0 };
+    int maxOverflow{ 0 };
+    double cpuSeconds{ 0. };
+};
+
+//@brief: a straight piece of a route between the centers of two gcells, in design
+//        coordinates with layers counted from 1, as writeRoutes writes it
+class RouteSegment
+{
+  public:
+    double x1{ 0. }, y1{ 0. }, x2{ 0. }, y2{ 0. };
+    unsigned z1{ 0 }, z2{ 0 };
+};
+
+//@brief: the route of a GR net
+class NetRoute
+{
+  public:
+    std::string name;
+    IdType dbId{ NULLID };
+    std::vector<RouteSegment> segments;
+};
+
+//@brief: passed to the progress callback at the end of each phase and after each
+//        rip-up and re-route iteration (`iteration` is 0 outside of it)
+class RouteProgress
+{
+  public:
+    const char *phase{ "" };
+    unsigned iteration{ 0 };
+    RouteStatistics statistics;
+};
+
+// returning false stops the run as if -deadline had passed
+using ProgressCallback = std::function<bool(const RouteProgress &)>;
+
+//@brief: congestion image of the routing grid, one usage ratio per pixel with the top
+//        row first (see SimpleGR::congestionMap). Written with the 64 color palette of
+//        the original mapper, scaled so that the worst ratio, or full, is the last color.
+class CongestionMap
+{
+  public:
+    enum Format { XPM, PPM, PNG };
+
+    unsigned width{ 0 }, height{ 0 };
+    std::vector<double> ratios;
+    // the ratio drawn with the last color, 0 for maxRatio()
+    double scale{ 0. };
+
+    // the largest ratio, at least 1
+    double maxRatio(void) const;
+    // writes `basename` plus the extension of `format`; false if it could not be written
+    bool write(const std::string &basename, Format format) const;
+
+    // false if `name` is not one of xpm, ppm or png
+    static bool parseFormat(const std::string &name, Format &format);
+    static const char *extension(Format format);
+};
+
 //@brief: GCell class is derived from Point to include coordinate on a grid
 //        It also contains the Id of edges connected to this gcell
 class GCell : public Point
@@ -156,7 +372,7 @@ class PQueue
       public:
         BitBoard() : setBits(0), bits(0) {}
         BitBoard(IdType size) : setBits(0), bits(size, false) {}
-        const std::vector<IdType> &getSetBits(void) { return setBits; }
+        const std::vector<IdType> &getSetBits(void) const { return setBits; }
         void setBit(IdType id)
         {
             if (!bits.at(id)) {
@@ -200,6 +416,8 @@ class PQueue
     }
     // check if nothing left in heap
     bool isEmpty() const { return heap.empty(); }
+    // number of gcells currently in the heap
+    std::size_t size() const { return heap.size(); }
     // Reset the priority queue to an empty state
     void clear();
 
@@ -214,6 +432,163 @@ class PQueue
     const GCellData &getGCellData(IdType gcellId) const;
     // Returns if a gcell has been visited previously
     bool isGCellVsted(IdType gcellId) const;
+    // Returns if a visited gcell is still in the heap, i.e. it has not been expanded yet
+    bool isGCellQueued(IdType gcellId) const { return isGCellVsted(gcellId) && data[gcellId].heapLoc != NULLID; }
+    // The gcells currently in the heap, in heap order
+    const std::vector<IdType> &getQueuedGCells(void) const { return heap; }
+    // Every gcell visited since the last clear
+    const std::vector<IdType> &getVisitedGCells(void) const { return dataValid.getSetBits(); }
+};
+
+//@brief: the routing phase a search belongs to, used to key telemetry records
+enum RoutePhase { FlatPhase, BulkPhase, RRRPhase, GreedyPhase };
+
+//@brief: per-call search metrics collected by routeMaze when telemetry is on
+class SearchStats
+{
+  public:
+    uint64_t expanded{ 0 };// gcells popped from the priority queue
+    uint64_t relaxations{ 0 };// neighbor cost updates pushed to the priority queue
+    std::size_t peakHeap{ 0 };// largest priority queue size seen during the search
+    uint64_t nanos{ 0 };// elapsed wall time of the search
+
+    void begin(void) { start = std::chrono::steady_clock::now(); }
+    void end(void)
+    {
+        nanos = static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+    }
+    void expand(void) { ++expanded; }
+    void relax(std::size_t heapSize)
+    {
+        ++relaxations;
+        peakHeap = std::max(peakHeap, heapSize);
+    }
+    // counts of a search made of several (the threads of routeDelta, or its retry)
+    void add(uint64_t expandedCount, uint64_t relaxedCount, std::size_t heapSize)
+    {
+        expanded += expandedCount;
+        relaxations += relaxedCount;
+        peakHeap = std::max(peakHeap, heapSize);
+    }
+    void add(const SearchStats &other) { add(other.expanded, other.relaxations, other.peakHeap); }
+
+  private:
+    std::chrono::steady_clock::time_point start;
+};
+
+//@brief: stand-in for SearchStats when telemetry is off, every call compiles away
+class NoSearchStats
+{
+  public:
+    void begin(void) {}
+    void end(void) {}
+    void expand(void) {}
+    void relax(std::size_t) {}
+    void add(uint64_t, uint64_t, std::size_t) {}
+    void add(const NoSearchStats &) {}
+};
+
+//@brief: writes one CSV record per routeMaze call, keyed by net ID and phase
+class SearchTelemetry
+{
+  public:
+    explicit SearchTelemetry(const std::string &filename);
+    bool good(void) const { return out.good(); }
+    void record(const Net &net,
+        RoutePhase phase,
+        unsigned iteration,
+        bool bboxFallback,
+        const SearchStats &stats,
+        std::size_t pathLen,
+        CostType cost);
+
+  private:
+    std::ofstream out;
+};
+
+//@brief: suboptimality achieved by the weighted A* searches of a phase. Each search
+//        contributes its route cost and a lower bound on the optimal cost.
+class SearchBound
+{
+  public:
+    unsigned searches{ 0 };
+    double routeCost{ 0. };
+    double lowerBound{ 0. };
+    double worst{ 1. };
+
+    void add(CostType cost, CostType bound)
+    {
+        ++searches;
+        routeCost += static_cast<double>(cost);
+        lowerBound += static_cast<double>(bound);
+        if (bound > 0.f) { worst = std::max(worst, static_cast<double>(cost / bound)); }
+    }
+    void merge(const SearchBound &o)
+    {
+        searches += o.searches;
+        routeCost += o.routeCost;
+        lowerBound += o.lowerBound;
+        worst = std::max(worst, o.worst);
+    }
+    // aggregate route cost over aggregate lower bound
+    double ratio(void) const { return lowerBound > 0. ? routeCost / lowerBound : 1.; }
+};
+
+//@brief: machine-readable results of a run, written as JSON with -report
+class RunReport
+{
+  public:
+    class Phase
+    {
+      public:
+        std::string name;
+        double wallSec;
+        double cpuSec;
+    };
+    // weighted A* settings and the bound achieved, one entry per phase or RRR iteration
+    class Search
+    {
+      public:
+        std::string phase;
+        unsigned iteration;
+        double weight;
+        SearchBound bound;
+    };
+    class Iteration
+    {
+      public:
+        unsigned iteration;
+        std::size_t netsRipped;
+        unsigned overfullEdges;
+        unsigned totalOverflow;
+        unsigned segments;
+        unsigned vias;
+        double wallSec;
+    };
+
+    std::vector<Phase> phases;
+    std::vector<Iteration> rrrIterations;
+    std::vector<Iteration> greedyIterations;
+    std::vector<Search> searches;
+    unsigned threads{ 1 };
+    unsigned patternRoutes{ 0 };// nets given a pattern route after the -deadline
+    unsigned priorRoutesKept{ 0 };// nets routed by -warmStart
+};
+
+//@brief: records the wall and CPU time of a routing phase into a RunReport
+class ScopedPhase
+{
+  public:
+    ScopedPhase(RunReport &report, const char *name) : report_(report), name_(name), wall_(wallTime()), cpu_(cpuTime())
+    {}
+    ~ScopedPhase() { report_.phases.push_back(RunReport::Phase{ name_, wallTime() - wall_, cpuTime() - cpu_ }); }
+
+  private:
+    RunReport &report_;
+    const char *name_;
+    double wall_;
+    double cpu_;
 };
 
 //@brief: manages commandline parameters passed to the SimpleGR
@@ -228,23 +603,455 @@ class SimpleGRParams
   public:
     bool layerAssign;
     bool verbose;
+    bool quiet;
     unsigned maxRipIter, maxGreedyIter;
     double timeOut;
+    double weight;// weighted A* inflation factor, 1 is exact A*
+    bool tightenWeight;// shrink the weight towards 1 over the phases
+    bool shareSource;// route nets sharing a pin gcell from one shortest-path tree
+    double staleness;// how much a tree route may have grown in cost before it is rerouted
+    bool routeCache;// memoize searches whose surroundings did not change
+    unsigned threads;// search threads, 0 for one per hardware thread
+    unsigned longNetSpan;// nets spanning this many gcells are searched on all threads, 0 for none
+    double deadline;// wall clock seconds for the whole run, 0 for none
+    std::string checkpointFile;// routing state saved during rip-up and re-route, see Checkpoint
+    unsigned checkpointEvery;// RRR iterations between checkpoints
+    std::string resumeFile;// checkpoint to continue from instead of routing from scratch
+    std::string warmStartFile;// solution whose routes are kept where they still fit
+    std::string congestionMapFile;// base name of the congestion maps written after each phase
+    CongestionMap::Format mapFormat;
+    unsigned mapDownsample;// gcells per congestion map pixel in each direction
+    bool congestionMovie;// also a congestion map after every RRR iteration
     std::string outputFile;
     std::string inputFile;
+    std::string telemetryFile;
+    std::string reportFile;
 
     SimpleGRParams(void) { setDefault(); }
     SimpleGRParams(int argc, char **argv);
+    bool parse(int argc, char **argv);
 
     static void usage(const char *exename);
 };
 
+//@brief: Admissible A* heuristic built from lower bounds on edge cost. Moving from
+//        column x to x+1 costs at least the cheapest horizontal edge between those
+//        columns over all rows, likewise for rows and vertical edges, so the bound
+//        of a move is a difference of prefix sums. A route that needs both
+//        directions also has to visit both layers (layer 0 is horizontal, layer 1
+//        vertical), which costs vias the plain Manhattan distance ignores.
+class PathLowerBound
+{
+  public:
+    // colCost[x] bounds the cost of crossing from column x to x+1, rowCost[y] from row y to y+1
+    void assign(const std::vector<CostType> &colCost, const std::vector<CostType> &rowCost);
+
+    inline CostType operator()(const Point a, const Point b) const
+    {
+        const CostType x_cost = colPrefix_[std::max(a.x, b.x)] - colPrefix_[std::min(a.x, b.x)];
+        const CostType y_cost = rowPrefix_[std::max(a.y, b.y)] - rowPrefix_[std::min(a.y, b.y)];
+
+        // a route that stays on its layer but needs the other direction goes up and back down
+        unsigned vias = a.z != b.z ? 1 : 0;
+        if (a.z == b.z && (a.z == 0 ? a.y != b.y : a.x != b.x)) { vias = 2; }
+
+        return x_cost + y_cost + static_cast<CostType>(vias) * viaFactor * edgeBase;
+    }
+
+    // changes whenever assign changes the bound
+    unsigned epoch(void) const { return epoch_; }
+
+  private:
+    std::vector<CostType> colPrefix_;
+    std::vector<CostType> rowPrefix_;
+    unsigned epoch_{ 0 };
+};
+
+//@brief: Memoizes maze searches. A search only depends on the edges around the gcells
+//        it visited, the heuristic and the weight, so its result is stored with the
+//        rectangle of tiles it visited (grown by one gcell) and a fingerprint of
+//        those tiles. Every tile keeps a hash of the usage and history of its edges,
+//        and one of which edges are full, updated as wires are added and ripped up.
+//        Searches under a cost that ignores usage only fingerprint the latter. A
+//        repeated search whose tiles hash the same returns the stored path without
+//        searching; adding and then removing a wire restores the hashes, so a net's
+//        own rip-up does not count.
+class RouteCache
+{
+  public:
+    static constexpr IdType tileSize = 4;// gcells per tile side
+
+    class Key
+    {
+      public:
+        IdType source, dest;
+        Point botleft, topright;
+        unsigned costKind;
+        bool allowOverflow;
+
+        bool operator==(const Key &o) const
+        {
+            return source == o.source && dest == o.dest && botleft == o.botleft && topright == o.topright
+                   && costKind == o.costKind && allowOverflow == o.allowOverflow;
+        }
+    };
+    class KeyHash
+    {
+      public:
+        std::size_t operator()(const Key &k) const
+        {
+            return (static_cast<std::size_t>(k.source) * 0x9e3779b97f4a7c15ULL) ^ (k.dest * 0x632be59bd9b4e019ULL)
+                   ^ (k.botleft.x + (k.botleft.y << 8) + (k.topright.x << 16) + (k.topright.y << 24))
+                   ^ (k.costKind << 1 | k.allowOverflow);
+        }
+    };
+    class Entry
+    {
+      public:
+        std::vector<IdType> path;// edges from dest to source, empty if no route was found
+        CostType cost;
+        CostType bound;// lower bound for SearchBound, 0 if the search was not weighted
+        Point tileLo, tileHi;// visited tiles, inclusive
+        unsigned boundEpoch;
+        CostType weight;
+        bool usageFree;// fingerprint only the full edges
+        uint64_t fingerprint;
+    };
+
+    unsigned hits{ 0 };
+    unsigned misses{ 0 };
 
-class EdgeCost;
+    // the cache is off until it's sized to a grid
+    bool enabled(void) const { return !usageHash_.empty(); }
+    void resize(IdType sizeX, IdType sizeY);
+    // record a change of `usageDelta` wire demand on the edge, and whether it filled up
+    // (+1) or reopened (-1)
+    void touchUsage(const Edge &edge, int64_t usageDelta, int fullDelta);
+    void touchHistory(const Edge &edge);
+    const Entry *find(const Key &key, unsigned boundEpoch, CostType weight);
+    void store(const Key &key, Entry &&entry);
+
+  private:
+    IdType tilesX_{ 0 }, tilesY_{ 0 };
+    std::vector<uint64_t> usageHash_;
+    std::vector<uint64_t> fullHash_;
+    std::unordered_map<Key, Entry, KeyHash> entries_;
+
+    uint64_t fingerprint(const Entry &entry) const;
+};
+
+//@brief: Connected components of the gcells, so a search between two components can
+//        be rejected without expanding anything. Each gcell carries a component
+//        label and the labels are merged with a union-find as edges open up. Closing
+//        edges are not tracked: the labels may claim a connection that no longer
+//        exists, which only costs a search, but never deny one that does. A failed
+//        exhaustive search has visited exactly its source's component, which then
+//        gets a label of its own (split).
+class GCellComponents
+{
+  public:
+    // labels[i] is the component of gcell i, all labels are below numLabels
+    void assign(std::vector<IdType> &&labels, IdType numLabels)
+    {
+        label_ = std::move(labels);
+        parent_.resize(numLabels);
+        for (IdType i = 0; i < numLabels; ++i) { parent_[i] = i; }
+    }
+
+    // without labels every pair of gcells counts as connected
+    bool connected(IdType a, IdType b) { return label_.empty() || root(label_[a]) == root(label_[b]); }
+    // same without path halving, safe while other threads only read as well
+    bool connectedShared(IdType a, IdType b) const
+    {
+        if (label_.empty()) { return true; }
+        IdType ra = label_[a], rb = label_[b];
+        while (parent_[ra] != ra) { ra = parent_[ra]; }
+        while (parent_[rb] != rb) { rb = parent_[rb]; }
+        return ra == rb;
+    }
+
+    // gcells a and b have been joined by an edge
+    void unite(IdType a, IdType b)
+    {
+        if (label_.empty()) { return; }
+        const IdType ra = root(label_[a]), rb = root(label_[b]);
+        if (ra != rb) { parent_[std::max(ra, rb)] = std::min(ra, rb); }
+    }
+
+    // `gcells` form a complete component
+    void split(const std::vector<IdType> &gcells)
+    {
+        if (label_.empty()) { return; }
+        const IdType newLabel = static_cast<IdType>(parent_.size());
+        parent_.push_back(newLabel);
+        for (const IdType id : gcells) { label_[id] = newLabel; }
+    }
+
+  private:
+    std::vector<IdType> label_;// per gcell
+    std::vector<IdType> parent_;// union-find over the labels
+
+    IdType root(IdType l)
+    {
+        while (parent_[l] != l) {
+            parent_[l] = parent_[parent_[l]];// path halving
+            l = parent_[l];
+        }
+        return l;
+    }
+};
+
+//@brief: Per-row bitsets over the grid for the Lee wavefront search (routeWavefront).
+//        Bit x of row (z, y) stands for gcell (x, y, z). The grid keeps which +x and +y
+//        edges leave every gcell, and which of them have room for another wire; SimpleGR
+//        flips the room bits as edges fill up and reopen.
+class WavefrontGrid
+{
+  public:
+    void resize(IdType sizeX, IdType sizeY, IdType layers)
+    {
+        sizeY_ = sizeY;
+        words_ = (sizeX + 63) / 64;
+        const std::size_t size = static_cast<std::size_t>(layers) * sizeY * words_;
+        xEdges_.assign(size, 0);
+        yEdges_.assign(size, 0);
+        xRoom_.assign(size, 0);
+        yRoom_.assign(size, 0);
+    }
+    bool built(void) const { return !xEdges_.empty(); }
+    IdType words(void) const { return words_; }
+    std::size_t size(void) const { return xEdges_.size(); }
+    // first word of row (z, y)
+    std::size_t row(IdType z, IdType y) const { return (static_cast<std::size_t>(z) * sizeY_ + y) * words_; }
+
+    // +x and +y edges, all of them or only those with room
+    const uint64_t *xEdges(bool room) const { return room ? xRoom_.data() : xEdges_.data(); }
+    const uint64_t *yEdges(bool room) const { return room ? yRoom_.data() : yEdges_.data(); }
+
+    void addEdge(const Edge &edge, bool room)
+    {
+        set(edge.type == HORIZ ? xEdges_ : yEdges_, edge, true);
+        set(edge.type == HORIZ ? xRoom_ : yRoom_, edge, room);
+    }
+    void setRoom(const Edge &edge, bool room)
+    {
+        if (built() && edge.type != VIA) { set(edge.type == HORIZ ? xRoom_ : yRoom_, edge, room); }
+    }
+
+    //@brief: after the edges are added, tabulate the fewest vias from layer z to layer
+    //        dstZ on a walk that also visits a layer with x edges if needX, and one with
+    //        y edges if needY
+    void findLayerVias(IdType layers)
+    {
+        layers_ = layers;
+        std::vector<IdType> xLayers, yLayers;
+        auto anyEdge = [&](const std::vector<uint64_t> &bits, IdType z) {
+            const uint64_t *first = bits.data() + row(z, 0);
+            return std::any_of(first, first + static_cast<std::size_t>(sizeY_) * words_, [](uint64_t w) { return w != 0; });
+        };
+        for (IdType z = 0; z < layers; ++z) {
+            if (anyEdge(xEdges_, z)) { xLayers.push_back(z); }
+            if (anyEdge(yEdges_, z)) { yLayers.push_back(z); }
+        }
+        // a walk from z to t covering [lo, hi]; a missing direction constrains nothing
+        auto walk = [](IdType z, IdType t, IdType lo, IdType hi) {
+            return std::min((z - lo) + (hi - lo) + (hi - t), (hi - z) + (hi - lo) + (t - lo));
+        };
+        const std::vector<IdType> any{ NULLID };
+        layerVias_.assign(static_cast<std::size_t>(layers) * layers * 4, 0);
+        for (IdType t = 0; t < layers; ++t) {
+            for (IdType z = 0; z < layers; ++z) {
+                for (unsigned need = 0; need < 4; ++need) {
+                    const auto &ps = (need & 1) && !xLayers.empty() ? xLayers : any;
+                    const auto &qs = (need & 2) && !yLayers.empty() ? yLayers : any;
+                    IdType best = NULLID;
+                    for (IdType p : ps) {
+                        for (IdType q : qs) {
+                            IdType lo = std::min(z, t), hi = std::max(z, t);
+                            for (IdType l : { p, q }) {
+                                if (l != NULLID) { lo = std::min(lo, l), hi = std::max(hi, l); }
+                            }
+                            best = std::min(best, walk(z, t, lo, hi));
+                        }
+                    }
+                    layerVias_[(static_cast<std::size_t>(t) * layers + z) * 4 + need] = best;
+                }
+            }
+        }
+    }
+    IdType layerVias(IdType z, IdType dstZ, bool needX, bool needY) const
+    {
+        return layerVias_[(static_cast<std::size_t>(dstZ) * layers_ + z) * 4 + (needX ? 1 : 0) + (needY ? 2 : 0)];
+    }
+
+  private:
+    IdType sizeY_{ 0 }, words_{ 0 }, layers_{ 0 };
+    std::vector<uint64_t> xEdges_, yEdges_, xRoom_, yRoom_;
+    std::vector<IdType> layerVias_;
+
+    void set(std::vector<uint64_t> &bits, const Edge &edge, bool value)
+    {
+        uint64_t &word = bits[row(edge.layer, edge.gcell1->y) + edge.gcell1->x / 64];
+        const uint64_t bit = uint64_t(1) << (edge.gcell1->x % 64);
+        word = value ? (word | bit) : (word & ~bit);
+    }
+};
+
+//@brief: scratch bitsets of one wavefront search, laid out like WavefrontGrid and
+//        all zero between searches
+class WavefrontScratch
+{
+  public:
+    // a via costs viaFactor wires, so pending wavefronts are kept for that many levels
+    static constexpr unsigned ring = 4;
+
+    std::vector<uint64_t> visited, frontier;
+    std::vector<uint64_t> pending[ring];// by level modulo ring
+    std::vector<uint64_t> box;// columns of the bounding box
+    std::vector<uint32_t> level;// per gcell, valid where visited
+
+    void resize(std::size_t bits, IdType words, std::size_t gcells)
+    {
+        if (visited.size() == bits && level.size() == gcells) { return; }
+        visited.assign(bits, 0);
+        frontier.assign(bits, 0);
+        for (auto &p : pending) { p.assign(bits, 0); }
+        box.assign(words, 0);
+        level.assign(gcells, 0);
+    }
+};
+
+//@brief: state of one routeDelta search shared by its threads. Labels hold the bits of
+//        each gcell's best path cost so far (non-negative floats order like their bits),
+//        stamps the light round a gcell was last expanded in. Labels are all unreached
+//        between searches.
+class DeltaScratch
+{
+  public:
+    static constexpr uint32_t unreached = ~uint32_t(0);
+
+    std::unique_ptr<std::atomic<uint32_t>[]> labels, stamps;
+    uint32_t round{ 0 };// last stamp handed out
+    // per worker: gcells queued by bucket, the bucket being expanded, gcells labeled
+    std::vector<std::vector<std::vector<IdType>>> buckets;
+    std::vector<std::vector<IdType>> current, touched;
+
+    void resize(std::size_t gcells, unsigned workers)
+    {
+        if (gcells != size_) {
+            labels.reset(new std::atomic<uint32_t>[gcells]);
+            stamps.reset(new std::atomic<uint32_t>[gcells]);
+            for (std::size_t i = 0; i < gcells; ++i) {
+                labels[i].store(unreached, std::memory_order_relaxed);
+                stamps[i].store(0, std::memory_order_relaxed);
+            }
+            size_ = gcells;
+            round = 0;
+        }
+        buckets.resize(workers);
+        current.resize(workers);
+        touched.resize(workers);
+    }
+
+    // stamps of earlier searches stay at or below `round`; start over long before it wraps
+    void beginSearch(void)
+    {
+        if (round < (uint32_t(1) << 31)) { return; }
+        for (std::size_t i = 0; i < size_; ++i) { stamps[i].store(0, std::memory_order_relaxed); }
+        round = 0;
+    }
+
+  private:
+    std::size_t size_{ 0 };
+};
+
+//@brief: routing state saved with -checkpoint and restored with -resume: the history cost
+//        of every edge and the route of every net, plus the rip-up and re-route progress.
+//        Capacities and usage are kept to check a resumed design is the same one and its
+//        routes replay to the same usage.
+class Checkpoint
+{
+  public:
+    IdType sizeX{ 0 }, sizeY{ 0 }, layers{ 0 };
+    unsigned iteration{ 0 };// RRR iterations completed, 0 right after initial routing
+    bool rrrDone{ false };// rip-up and re-route has ended
+    double rrrCpuSec{ 0. };// CPU time spent in rip-up and re-route, counted against -timeOut
+    std::vector<uint8_t> capacity, usage;
+    std::vector<CostType> history;
+    std::vector<uint8_t> routed;
+    // net i's route is routeEdges[routeBegin[i], routeBegin[i + 1])
+    std::vector<IdType> routeBegin, routeEdges;
+
+    // whole file at once, through a temporary file renamed over `filename`
+    bool write(const std::string &filename) const;
+    bool read(const std::string &filename);
+};
+
+//@brief: writes checkpoints on a background thread, at most one at a time
+class CheckpointWriter
+{
+  public:
+    ~CheckpointWriter() { wait(); }
+
+    bool busy(void) const { return thread_.joinable() && !done_.load(std::memory_order_acquire); }
+    void write(Checkpoint &&checkpoint, const std::string &filename);
+    void wait(void)
+    {
+        if (thread_.joinable()) { thread_.join(); }
+    }
+
+  private:
+    std::thread thread_;
+    std::atomic<bool> done_{ true };
+};
+
+//@brief: the grid and search buffers of a SimpleGR done with its design, handed to the
+//        next one with adoptBuffers so that designs of similar size reuse their memory
+class RouterBuffers
+{
+  public:
+    std::vector<std::vector<std::vector<GCell>>> gcells;
+    std::vector<Edge> edges;
+    PQueue queue;
+    std::vector<PQueue> workerQueues;
+    WavefrontScratch wavefrontScratch;
+    std::vector<WavefrontScratch> workerScratch;
+    DeltaScratch deltaScratch;
+};
+
+//@brief: a std::cout buffer that sends the output of each thread to the buffer set as
+//        its `target`, and of threads without one to `fallback`, so that designs routed
+//        at the same time in one process each get their own log. A target must accept
+//        everything, since a failed write would fail std::cout for every thread.
+class ThreadLogBuf : public std::streambuf
+{
+  public:
+    static thread_local std::streambuf *target;
+
+    explicit ThreadLogBuf(std::streambuf *fallback) : fallback_(fallback) {}
+
+  protected:
+    int overflow(int c) override
+    {
+        return c == traits_type::eof() ? traits_type::not_eof(c) : sink()->sputc(static_cast<char>(c));
+    }
+    std::streamsize xsputn(const char *s, std::streamsize n) override { return sink()->sputn(s, n); }
+    int sync() override { return sink()->pubsync(); }
+
+  private:
+    std::streambuf *fallback_;
+
+    std::streambuf *sink(void) const { return target != nullptr ? target : fallback_; }
+};
+
+class UnitEdgeCost;
+class DLMEdgeCost;
 
 class SimpleGR
 {
-    friend class EdgeCost;
+    friend class UnitEdgeCost;
+    friend class DLMEdgeCost;
+    friend class GRBench;
 
   private:
     // design stats
@@ -257,15 +1064,72 @@ class SimpleGR
     // global routing data
     std::vector<CapType> vertCaps, horizCaps, minWidths, minSpacings, viaSpacings;
     std::vector<Net> grNetArr;
-    std::vector<std::string> netNameArr;
+    // names of all nets of the design; entry i is the name of GR net i, the nets that
+    // are not routed come after them
+    NetNameIndex netNames;
     std::vector<IdType> netDBIdArr;
     std::vector<std::vector<std::vector<GCell>>> gcellArr3D;
     std::vector<Edge> grEdgeArr;
     PQueue priorityQueue;
-    std::map<std::string, Net *> netNameToPtrMap;
 
     SimpleGRParams params;
 
+    // per-search telemetry, only allocated when requested with -telemetry
+    std::unique_ptr<SearchTelemetry> telemetry;
+    RoutePhase curPhase;
+    unsigned curIteration;
+
+    RunReport runReport;
+
+    // heuristic inflation of the current phase, and the bound its searches achieved
+    CostType searchWeight;
+    SearchBound searchBound;
+
+    // A* heuristics for each cost function, see refreshDLMBound
+    PathLowerBound unitBound;
+    PathLowerBound dlmBound;
+    const PathLowerBound &pathBound(const UnitEdgeCost &) const { return unitBound; }
+    const PathLowerBound &pathBound(const DLMEdgeCost &) const { return dlmBound; }
+    void refreshDLMBound(const std::vector<IdType> &netsToReroute);
+
+    // memoized searches, only sized (enabled) with -routeCache
+    RouteCache routeCache;
+
+    // Parallel searches: worker w > 0 searches with workerQueues[w - 1] and records
+    // into workerBounds[w - 1], worker 0 (the main thread) uses priorityQueue and
+    // searchBound. Set by each thread before it searches.
+    static thread_local unsigned searchWorker;
+    // set on every thread of a parallel batch, worker 0 included, while the others may be
+    // searching: the searches then only read the components and leave the cache alone
+    static thread_local bool searchShared;
+    std::vector<PQueue> workerQueues;
+    std::vector<SearchBound> workerBounds;
+    PQueue &searchQueue(void) { return searchWorker > 0 ? workerQueues[searchWorker - 1] : priorityQueue; }
+    void prepareWorkers(unsigned threads);
+
+    // Lee wavefront search for unit cost, built at greedy improvement, see routeWavefront
+    WavefrontGrid wavefront;
+    WavefrontScratch wavefrontScratch;
+    std::vector<WavefrontScratch> workerScratch;
+    void buildWavefront(void);
+
+    // threads of routeDelta, more than one only with -longNetSpan, kept between searches
+    unsigned longNetThreads{ 1 };
+    DeltaScratch deltaScratch;
+    WorkerPool deltaPool;
+
+    // components over all edges, and over the edges with room for one more wire
+    GCellComponents gridComponents;
+    GCellComponents freeComponents;
+    void buildComponents(bool freeOnly);
+
+    //@brief: whether one more wire fits on the edge without overflow
+    bool edgeHasRoom(const Edge &edge) const
+    {
+        const CapType demand = (edge.type == VIA) ? 0 : minWidths[edge.layer] + minSpacings[edge.layer];
+        return edge.usage + demand <= edge.capacity;
+    }
+
     inline IdType gcellCoordToId(const CoordType x, const CoordType y, const CoordType z) const
     {
         assert(x < gcellArrSzX);
@@ -320,39 +1184,169 @@ class SimpleGR
     //@brief: get the gcell's ID from a gcell
     IdType getGCellId(const Point gcell) { return gcellCoordToId(gcell.x, gcell.y, gcell.z); }
 
-    void buildGrid(void);
+    bool readAdjustments(TextScanner &infile, std::vector<CapType> &wireCaps);
+    void buildGrid(const std::vector<CapType> &wireCaps, bool disconnectBlocked);
 
     void addSegment(Net &net, Edge &edge);
     void ripUpSegment(const IdType netId, IdType edgeId);
     void ripUpNet(const IdType netId);
 
-    void routeFlatNets(bool allowOverflow, const EdgeCost &func);
-    CostType routeNet(Net &net, bool allowOverflow, bool bboxConstrain, const EdgeCost &f);
-    void routeNets(bool allowOverflow, const EdgeCost &func);
-
-    CostType routeMaze(Net &net,
+    // Cost is UnitEdgeCost or DLMEdgeCost, passed by value down to the search
+    template<typename Cost>
+    void routeFlatNets(bool allowOverflow, Cost cost);
+    template<typename Cost>
+    CostType routeNet(Net &net, bool allowOverflow, bool bboxConstrain, Cost cost);
+    template<typename Cost, typename Stats>
+    CostType routeNetImpl(Net &net, bool allowOverflow, bool bboxConstrain, Cost cost);
+    template<typename Cost>
+    void routeNets(bool allowOverflow, Cost cost);
+
+    // nets that share a pin gcell, routed from one shortest-path tree
+    std::vector<std::vector<IdType>> groupBySharedPin(const std::vector<IdType> &netIds,
+        std::vector<IdType> &sources) const;
+    template<typename Cost>
+    unsigned routeGroup(IdType sourceId,
+        const std::vector<IdType> &netIds,
         bool allowOverflow,
+        bool bboxConstrain,
+        bool ripUpFirst,
+        Cost cost);
+    template<typename Cost, bool AllowOverflow>
+    void routeTree(IdType sourceId,
+        const std::vector<IdType> &targetIds,
         const Point &botleft,
         const Point &topright,
-        const EdgeCost &func,
-        std::vector<Edge *> &path);
+        Cost cost,
+        std::vector<std::vector<Edge *>> &paths,
+        std::vector<CostType> &costs);
+    void tracePath(IdType sourceId, IdType destId, std::vector<Edge *> &path);
+
+    // greedy improvement of a batch of nets, searched in parallel
+    template<typename Stats>
+    unsigned routeBatch(const std::vector<IdType> &netIds, UnitEdgeCost cost, std::vector<CapType> &reserved);
+    // greedy reroute of one net, keeping its old route if the search gave up
+    void rerouteNet(IdType netId, UnitEdgeCost cost);
+
+    // -deadline: whether it has passed, and whether searches give up once it has. It
+    // counts from runStart, the wall time at which the run (or a reroute) began.
+    bool timeUp(void) const
+    {
+        return stopRequested || (params.deadline > 0. && wallTime() - runStart >= params.deadline);
+    }
+    double runStart{ 0. };
+    bool searchDeadline{ false };
+    // L-shaped routes for the nets left unrouted when time ran out
+    bool routePattern(Net &net);
+    void routeRemaining(const char *phase);
+
+    // -checkpoint and -resume, see Checkpoint.cpp. A checkpoint still being written is
+    // skipped unless it is the last one of rip-up and re-route.
+    CheckpointWriter checkpointWriter;
+    Checkpoint resumed;// progress of the checkpoint resumed from
+    void saveCheckpoint(unsigned iteration, bool rrrDone, double rrrCpuSec);
+    bool loadCheckpoint(void);
+
+    // progress callback of the library interface, and whether it asked to stop
+    ProgressCallback progress;
+    bool stopRequested{ false };
+    void reportProgress(const char *phase, unsigned iteration);
+
+    // why the last design could not be read
+    std::string parseMessage;
+    bool parseDesign(TextScanner &infile, bool forRouting);
+    bool parseFailed(const std::string &reason);
+    // the routed edges of a net merged into straight runs between gcells
+    void netSegments(IdType netId, std::vector<std::pair<Point, Point>> &segments) const;
+
+    bool segmentEdges(const double from[3], const double to[3], std::vector<IdType> &edges) const;
+    bool routeConnects(const Net &net, const std::vector<IdType> &edges, bool noStubs, RouteScratch &scratch) const;
+
+    // color scale of the -congestionMovie frames, that of the first map written
+    double movieScale{ 0. };
+    void writeCongestionMaps(const char *phase);
+    void writeCongestionFrame(unsigned iteration);
+
+    // -warmStart: set for the nets still on the route they were given by the prior
+    // solution, empty without the option
+    std::vector<char> priorRoute;
+    bool warmStart(void);
+
+    // One search per cost function, overflow policy and Stats (SearchStats or
+    // NoSearchStats), see MazeRouter.cpp for the instantiations
+    template<typename Cost, bool AllowOverflow, typename Stats>
+    CostType routeMaze(Net &net,
+        const Point &botleft,
+        const Point &topright,
+        Cost cost,
+        std::vector<Edge *> &path,
+        Stats &stats);
+
+    // Bit-parallel breadth-first search under unit cost, same route cost as routeMaze
+    template<bool AllowOverflow, typename Stats>
+    CostType routeWavefront(Net &net,
+        const Point &botleft,
+        const Point &topright,
+        std::vector<Edge *> &path,
+        Stats &stats);
+
+    // Delta-stepping over all longNetThreads threads, for one long net; same route
+    // cost as exact routeMaze
+    template<typename Cost, bool AllowOverflow, typename Stats>
+    CostType routeDelta(Net &net,
+        const Point &botleft,
+        const Point &topright,
+        Cost cost,
+        std::vector<Edge *> &path,
+        Stats &stats);
+
+    // routeMaze, or routeWavefront for unit cost once the wavefront grid is built, or
+    // routeDelta for a long net searched alone
+    template<typename Cost, bool AllowOverflow, typename Stats>
+    CostType routeSearch(Net &net,
+        const Point &botleft,
+        const Point &topright,
+        Cost cost,
+        std::vector<Edge *> &path,
+        Stats &stats)
+    {
+        if constexpr (std::is_same<Cost, UnitEdgeCost>::value) {
+            if (wavefront.built()) { return routeWavefront<AllowOverflow>(net, botleft, topright, path, stats); }
+        }
+        if (longNetThreads > 1 && !searchShared) {
+            const CoordType span = std::max(net.gCellOne.x, net.gCellTwo.x) - std::min(net.gCellOne.x, net.gCellTwo.x)
+                                   + std::max(net.gCellOne.y, net.gCellTwo.y) - std::min(net.gCellOne.y, net.gCellTwo.y);
+            if (span >= params.longNetSpan) {
+                return routeDelta<Cost, AllowOverflow>(net, botleft, topright, cost, path, stats);
+            }
+        }
+        return routeMaze<Cost, AllowOverflow>(net, botleft, topright, cost, path, stats);
+    }
 
     // !!! More function declarations should go here
     // !!!function declare
+    void openTelemetry(void);
+    void beginSearches(double weight);
+    void endSearches(const char *phase, unsigned iteration);
 
   public:
     // Constructor
     SimpleGR(const SimpleGRParams &_params = SimpleGRParams())
         : gcellArrSzX(0), gcellArrSzY(0), numLayers(0), routableNets(0), nonViaEdges(0), minX(0), minY(0),
           gcellWidth(0), gcellHeight(0), halfWidth(0), halfHeight(0), totalOverflow(0), overfullEdges(0),
-          totalSegments(0), totalVias(0), params(_params)
-    {}
+          totalSegments(0), totalVias(0), params(_params), curPhase(FlatPhase), curIteration(0), searchWeight(1.f)
+    {
+        if (!params.telemetryFile.empty()) { openTelemetry(); }
+        runReport.threads = resolveThreads(params.threads);
+    }
 
-    void parseInput();
-    void parseInputMapper(const char *filename);
+    bool parseInput();
+    // why parseInput, or initialRouting reading -resume or -warmStart, failed
+    const std::string &parseError(void) const { return parseMessage; }
+    bool parseInputMapper(const char *filename);
     void parseSolution(const char *filename);
     void writeRoutes(void);
-    void initialRouting(void);
+    void writeReport(void);
+    bool initialRouting(void);
     void doRRR(void);
     void greedyImprovement(void);
 
@@ -360,7 +1354,38 @@ class SimpleGR
     void printStatistics(bool checkRouted = true, bool final = false);
     void printStatisticsLight(void);
 
-    void plotXPM(const std::string &filename);
+    //@brief: usage ratio of the wire edges leaving each gcell, the worst of every block
+    //        of `downsample` x `downsample` gcells, computed by rows on -threads
+    //        (all layers, or only `layer`)
+    CongestionMap congestionMap(unsigned downsample, IdType layer = NULLID) const;
+    void plotCongestion(const std::string &filename, CongestionMap::Format format, unsigned downsample = 1);
+
+    //@brief: check a solution against the design loaded with parseInputMapper and report
+    //        its overflow per net (as CSV to `netReport` if not empty); returns 0 if it is
+    //        legal, 1 if legal with overflow, 2 if illegal
+    int verifySolution(const char *filename, const std::string &netReport);
+
+    //@brief: in-memory interface of the simplegr library, see Library.cpp. A design is
+    //        parsed from the text of a .gr file (false if it is malformed, see parseError),
+    //        then route runs the three phases (false if initial routing could not read
+    //        -resume or -warmStart, see parseError) and statistics and routes return the result
+    //        without writing files
+    bool parseInput(std::string_view design);
+    void setProgressCallback(ProgressCallback callback) { progress = std::move(callback); }
+    bool route(void);
+    RouteStatistics statistics(bool checkRouted = true) const;
+    std::vector<NetRoute> routes(void) const;
+
+    //@brief: take the buffers of an earlier design before parsing, and give them back
+    //        once done with this one (see RouterBuffers)
+    void adoptBuffers(RouterBuffers &buffers);
+    void releaseBuffers(RouterBuffers &buffers);
+
+    //@brief: the ID of a GR net, false for unknown nets and nets within one gcell
+    bool findNet(std::string_view name, IdType &netId) const { return netNames.find(name, netId) && netId != NULLID; }
+    void rerouteNets(std::vector<IdType> netIds);
+    // the routes of the routed GR nets in the format of -o
+    void writeSolution(std::ostream &outfile) const;
 };
 
 //@brief: Functor class defined to compare nets by their bounding boxes
@@ -374,59 +1399,55 @@ class CompareByBox
     bool operator()(const IdType a, const IdType b) const;
 };
 
-//@brief: Edge cost function class. It will be extensively used by the MazeRouter.
-//@note:  This class is a Singleton -- it is instantiated only once, but can be
-//        referenced globally. It is also a Functor that computes the cost of
-//        an edge.
-class EdgeCost
+//@brief: Edge cost functions used by the MazeRouter. Both are small value types
+//        that copy the router's edge data pointers on construction, so they are
+//        passed by value and routeMaze is instantiated once per cost function,
+//        leaving no branch on the cost type in the search loop.
+//@note:  A cost object must not outlive a change to the size of the edge array.
+inline CostType viaCost(void)
+{
+    return viaFactor * edgeBase;// 3x as costly as a "regular" segment
+}
+
+// Unit cost treats all edges as equal, returns a unified cost
+class UnitEdgeCost
 {
   public:
-    // Two types of cost functions are defined here
-    enum EdgeCostType { UnitCost, DLMCost };
-    // Use this API to get a reference of this cost function
-    static EdgeCost &getFunc(const SimpleGR *p_gr)
-    {
-        static EdgeCost costf(p_gr);
-        return costf;
-    }
-    // Functor API. Returns cost of the edge
-    inline CostType operator()(IdType edgeId) const
-    {
-        const Edge &edge = p_gr_->grEdgeArr[edgeId];
-        if (edge.type == VIA) {
-            return viaCost();
-        } else if (type_ == UnitCost) {
-            return Unit();
-        } else {
-            return DLM(edge);
-        }
-    }
-    // This API sets the cost function type for the proper circumstance
-    void setType(EdgeCostType type) { type_ = type; }
+    static constexpr unsigned kind = 0;// RouteCache key
+    static constexpr bool usageFree = true;// the cost ignores usage, only room matters
+
+    explicit UnitEdgeCost(const SimpleGR &gr) : edges_(gr.grEdgeArr.data()) {}
+
+    inline CostType operator()(IdType edgeId) const { return edges_[edgeId].type == VIA ? viaCost() : edgeBase; }
 
   private:
-    const SimpleGR *p_gr_;
-    EdgeCostType type_;
-    EdgeCost(const SimpleGR *p_gr) : p_gr_(p_gr), type_(DLMCost)
-    {// Not Implemented
-    }
-    EdgeCost(EdgeCost const &);// Not Implemented
-    void operator=(EdgeCost const &);// Not Implemented
+    const Edge *edges_;
+};
+
+// DLM cost considers congestion. High congestion is heavily penalized.
+// DLM also uses historyCost to penalize edges that repeated overflow
+class DLMEdgeCost
+{
+  public:
+    static constexpr unsigned kind = 1;// RouteCache key
+    static constexpr bool usageFree = false;
+
+    explicit DLMEdgeCost(const SimpleGR &gr)
+        : edges_(gr.grEdgeArr.data()), minWidths_(gr.minWidths.data()), minSpacings_(gr.minSpacings.data())
+    {}
 
-    inline CostType viaCost(void) const
+    inline CostType operator()(IdType edgeId) const
     {
-        return viaFactor * edgeBase;// 3x as costly as a "regular" segment
+        const Edge &edge = edges_[edgeId];
+        if (edge.type == VIA) { return viaCost(); }
+        return wireCost(edge, edge.usage);
     }
 
-    // Unit cost treats all edges as equal, returns a unified cost
-    inline CostType Unit(void) const { return edgeBase; }
-
-    // DLM cost considers congestion. High congestion is heavily penalized.
-    // DLM also uses historyCost to penalize edges that repeated overflow
-    CostType DLM(const Edge &edge) const
+    // cost of a wire edge as if it had `usage`; DLM cost never decreases with usage
+    CostType wireCost(const Edge &edge, CapType usage) const
     {
         const CapType capacity = edge.capacity;
-        const CapType newUsage = edge.usage + p_gr_->minWidths[edge.layer] + p_gr_->minSpacings[edge.layer];
+        const CapType newUsage = usage + minWidths_[edge.layer] + minSpacings_[edge.layer];
 
         CostType uRatio = static_cast<CostType>(newUsage) / static_cast<CostType>(capacity);
         if (newUsage > capacity) {
@@ -435,6 +1456,11 @@ class EdgeCost
             return edgeBase + edge.historyCost * uRatio;
         }
     }
+
+  private:
+    const Edge *edges_;
+    const CapType *minWidths_;
+    const CapType *minSpacings_;
 };
 
 //@brief: Computes the Manhattan distance between two gcells. This cost function can
@@ -471,17 +1497,20 @@ class ManhattanCost
 class SimpleProgRpt
 {
   public:
-    SimpleProgRpt(const std::size_t size_) : checkpoint(NULL), len(0), k(0), j(0), size(static_cast<uint32_t>(size_))
+    // a quiet report prints nothing at all
+    SimpleProgRpt(const std::size_t size_, bool quiet_ = false)
+        : checkpoint(NULL), len(0), k(0), j(0), size(static_cast<uint32_t>(size_)), quiet(quiet_)
     {
         int handwritten[] = { 10, 30, 50, 70, 90 };
         set(handwritten, sizeof(handwritten));
-        std::cout << "scheduled number of workloads : " << size_ << std::endl;
+        if (!quiet) { std::cout << "scheduled number of workloads : " << size_ << '\n'; }
     }
-    SimpleProgRpt(const unsigned size_) : checkpoint(NULL), len(0), k(0), j(0), size(size_)
+    SimpleProgRpt(const unsigned size_, bool quiet_ = false)
+        : checkpoint(NULL), len(0), k(0), j(0), size(size_), quiet(quiet_)
     {
         int handwritten[] = { 10, 30, 50, 70, 90 };
         set(handwritten, sizeof(handwritten));
-        std::cout << "scheduled number of workloads : " << size_ << std::endl;
+        if (!quiet) { std::cout << "scheduled number of workloads : " << size_ << '\n'; }
     }
     void update(unsigned i);
     ~SimpleProgRpt()
@@ -502,10 +1531,9 @@ class SimpleProgRpt
     int len;
     int k, j;
     const unsigned size;
+    const bool quiet;
 };
 
-//@brief: A simple CPU timer API
-double cpuTime(void);
 
 
 #endif
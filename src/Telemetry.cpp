@@ -0,0 +1,65 @@
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include "SimpleGR.h"
+
+static const char *phaseName(RoutePhase phase)
+{
+    switch (phase) {
+    case FlatPhase:
+        return "flat";
+    case BulkPhase:
+        return "bulk";
+    case RRRPhase:
+        return "rrr";
+    case GreedyPhase:
+        return "greedy";
+    }
+    return "unknown";
+}
+
+SearchTelemetry::SearchTelemetry(const std::string &filename) : out(filename.c_str())
+{
+    if (out.good()) {
+        out << "net,phase,iteration,bbox_fallback,expanded,relaxations,peak_heap,path_len,manhattan,cost,ns\n";
+    }
+}
+
+//@brief: append one search record. path_len is the number of edges on the found path
+//        (0 if the search failed) and manhattan is the pin-to-pin distance in gcell steps,
+//        vias included, so path_len / manhattan shows how far the route detours.
+void SearchTelemetry::record(const Net &net,
+    RoutePhase phase,
+    unsigned iteration,
+    bool bboxFallback,
+    const SearchStats &stats,
+    std::size_t pathLen,
+    CostType cost)
+{
+    auto dist = [](CoordType a, CoordType b) { return a > b ? a - b : b - a; };
+    const CoordType manhattan = dist(net.gCellOne.x, net.gCellTwo.x) + dist(net.gCellOne.y, net.gCellTwo.y)
+                                + dist(net.gCellOne.z, net.gCellTwo.z);
+
+    out << net.id << ',' << phaseName(phase) << ',' << iteration << ',' << (bboxFallback ? 1 : 0) << ','
+        << stats.expanded << ',' << stats.relaxations << ',' << stats.peakHeap << ',' << pathLen << ',' << manhattan
+        << ',';
+    if (pathLen > 0) {
+        out << cost;
+    } else {
+        out << "inf";
+    }
+    out << ',' << stats.nanos << '\n';
+}
+
+//@brief: open the telemetry log requested on the command line
+void SimpleGR::openTelemetry(void)
+{
+    telemetry.reset(new SearchTelemetry(params.telemetryFile));
+    if (!telemetry->good()) {
+        std::cout << "Warning: could not open `" << params.telemetryFile << "' for writing, telemetry disabled"
+                  << std::endl;
+        telemetry.reset();
+    }
+}
@@ -1,4 +1,5 @@
 #include <cassert>
+#include <chrono>
 #include <cstdlib>
 #include <iostream>
 #include <random>
@@ -6,6 +7,7 @@
 #include <sys/resource.h>
 #include <vector>
 
+#include "Profiler.h"
 #include "SimpleGR.h"
 
 double cpuTime(void)
@@ -17,38 +19,50 @@ double cpuTime(void)
            + static_cast<double>(cputime.ru_stime.tv_sec) + (1.e-6) * static_cast<double>(cputime.ru_stime.tv_usec);
 }
 
-void SimpleGR::printStatistics(bool checkRouted, bool final)
+// captured during static initialization, i.e. right as the process starts
+static const std::chrono::steady_clock::time_point processStart = std::chrono::steady_clock::now();
+
+double wallTime(void)
 {
-    std::cout << "\nGR Stats :\n";
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - processStart).count();
+}
 
-    int maxOverfill = 0;
-    for (unsigned i = 0; i < grEdgeArr.size(); ++i) {
-        maxOverfill = std::max(maxOverfill, static_cast<int>(grEdgeArr[i].usage - grEdgeArr[i].capacity));
-    }
+long peakRSSKb(void)
+{
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;// kilobytes on Linux
+}
 
-    unsigned netsRouted = 0, routedLen = 0, numVias = 0;
-    for (unsigned i = 0; i < grNetArr.size(); ++i) {
-        if (!checkRouted || grNetArr[i].routed) {
-            ++netsRouted;
-            numVias += grNetArr[i].numVias;
-            routedLen += grNetArr[i].numSegments;
-        }
+uint64_t fnv1a(const char *data, std::size_t size)
+{
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (std::size_t i = 0; i < size; ++i) {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= 0x100000001b3ULL;
     }
+    return hash;
+}
+
+void SimpleGR::printStatistics(bool checkRouted, bool final)
+{
+    std::cout << "\nGR Stats :\n";
+
+    const RouteStatistics stats = statistics(checkRouted);
 
     std::string stringFinal = final ? " Final " : " ";
 
-    std::cout << stringFinal << "nets routed " << netsRouted << " ("
-              << 100. * static_cast<double>(netsRouted) / static_cast<double>(routableNets) << "%)" << std::endl;
-    std::cout << stringFinal << "total length for routed nets " << routedLen << std::endl;
-    std::cout << stringFinal << "total number of vias " << numVias << std::endl;
-    std::cout << stringFinal << "total wire length "
-              << static_cast<CostType>(routedLen) + viaFactor * static_cast<CostType>(numVias) << std::endl;
+    std::cout << stringFinal << "nets routed " << stats.netsRouted << " ("
+              << 100. * static_cast<double>(stats.netsRouted) / static_cast<double>(routableNets) << "%)" << std::endl;
+    std::cout << stringFinal << "total length for routed nets " << stats.routedLength << std::endl;
+    std::cout << stringFinal << "total number of vias " << stats.vias << std::endl;
+    std::cout << stringFinal << "total wire length " << stats.wireLength << std::endl;
     std::cout << stringFinal << "number of overflowing edges is " << overfullEdges << " ("
               << 100. * static_cast<double>(overfullEdges) / static_cast<double>(nonViaEdges) << "%)" << std::endl;
-    std::cout << stringFinal << "max overflow is " << maxOverfill << std::endl;
+    std::cout << stringFinal << "max overflow is " << stats.maxOverflow << std::endl;
     std::cout << stringFinal << "total overflow is " << totalOverflow << std::endl;
     std::cout << stringFinal << "avg overflow is " << totalOverflow / static_cast<double>(nonViaEdges) << std::endl;
-    std::cout << stringFinal << "CPU time: " << cpuTime() << " seconds\n" << std::endl;
+    std::cout << stringFinal << "CPU time: " << stats.cpuSeconds << " seconds\n" << std::endl;
 }
 
 void SimpleGR::printStatisticsLight(void)
@@ -68,10 +82,17 @@ void SimpleGR::printStatisticsLight(void)
     cout << "CPU time: " << cpuTime() << " seconds" << endl << flush;
 }
 
-//@brief: building the routing grid and initialize it with the default capacity
-//        this should be done before the edge capacity adjustment
-void SimpleGR::buildGrid(void)
+//@brief: build the routing grid. The gcells and edges are allocated at their final
+//        size and filled in parallel, horizontal edges by row and vertical edges and
+//        vias by column, taking their capacities from `wireCaps` (see readAdjustments;
+//        empty for the default capacities). An edge of capacity 0 is removed from its
+//        gcells (it stays in grEdgeArr) when `disconnectBlocked` is set. Edge IDs run
+//        over the horizontal edges row by row, then the vertical edges and the vias
+//        column by column.
+void SimpleGR::buildGrid(const std::vector<CapType> &wireCaps, bool disconnectBlocked)
 {
+    GR_PROFILE_PHASE("buildGrid");
+
     // Note: Hard coded to work with 2 layers only
     assert(numLayers == 2);
 
@@ -79,84 +100,225 @@ void SimpleGR::buildGrid(void)
     assert(horizCaps[0]);
     assert(vertCaps[1]);
 
-    // Allocate a 3D matrix for the gcell grid
-    // Note: all gcells created this way are constructed by their default constructor
+    const IdType sizeX = gcellArrSzX, sizeY = gcellArrSzY;
+    const unsigned threads = resolveThreads(params.threads);
+
+    const IdType numHoriz = sizeY * (sizeX - 1);
+    const IdType numVert = sizeX * (sizeY - 1);
+    const IdType numVias = sizeX * sizeY;
+
+    // Allocate everything at its final size, in the memory of adopted buffers if any; the
+    // rows of gcells are filled in parallel
     gcellArr3D.resize(numLayers);
-    for (unsigned k = 0; k < numLayers; ++k) {
-        gcellArr3D[k].resize(gcellArrSzY);
-        for (unsigned j = 0; j < gcellArrSzY; ++j) { gcellArr3D[k][j].resize(gcellArrSzX); }
+    for (std::vector<std::vector<GCell>> &layer : gcellArr3D) { layer.resize(sizeY); }
+    grEdgeArr.clear();
+    grEdgeArr.resize(static_cast<std::size_t>(numHoriz) + numVert + numVias);
+    parallelFor(static_cast<std::size_t>(numLayers) * sizeY, threads, [&](std::size_t row, unsigned) {
+        const CoordType z = static_cast<CoordType>(row / sizeY), y = static_cast<CoordType>(row % sizeY);
+        std::vector<GCell> &gcells = gcellArr3D[z][y];
+        gcells.assign(sizeX, GCell());
+        for (CoordType x = 0; x < sizeX; ++x) { gcells[x].setCoord(x, y, z); }
+    });
+
+    auto makeEdge = [&](IdType edgeId, GCell &gcell1, GCell &gcell2, EdgeType type, CapType capacity) {
+        Edge &edge = grEdgeArr[edgeId];
+        edge.gcell1 = &gcell1;
+        edge.gcell2 = &gcell2;
+        edge.capacity = capacity;
+        edge.type = static_cast<uint8_t>(type);
+        edge.usage = 0;
+        edge.layer = type == HORIZ ? 0 : 1;// vias are assigned to the upper layer
+        edge.id = edgeId;
+    };
+
+    // horizontal edges on the first layer, one row per task
+    parallelFor(sizeY, threads, [&](std::size_t row, unsigned) {
+        const CoordType y = static_cast<CoordType>(row);
+        std::vector<GCell> &gcells = gcellArr3D[0][y];
+        for (CoordType x = 0; x + 1 < sizeX; ++x) {
+            const IdType edgeId = y * (sizeX - 1) + x;
+            const CapType capacity = wireCaps.empty() ? horizCaps[0] : wireCaps[edgeId];
+            makeEdge(edgeId, gcells[x], gcells[x + 1], HORIZ, capacity);
+            if (capacity > 0 || !disconnectBlocked) {
+                gcells[x].incX = edgeId;
+                gcells[x + 1].decX = edgeId;
+            }
+        }
+    });
+
+    // vertical edges on the second layer, one column per task
+    parallelFor(sizeX, threads, [&](std::size_t col, unsigned) {
+        const CoordType x = static_cast<CoordType>(col);
+        for (CoordType y = 0; y + 1 < sizeY; ++y) {
+            const IdType edgeId = numHoriz + x * (sizeY - 1) + y;
+            const CapType capacity = wireCaps.empty() ? vertCaps[1] : wireCaps[edgeId];
+            GCell &gcell1 = gcellArr3D[1][y][x], &gcell2 = gcellArr3D[1][y + 1][x];
+            makeEdge(edgeId, gcell1, gcell2, VERT, capacity);
+            if (capacity > 0 || !disconnectBlocked) {
+                gcell1.incY = edgeId;
+                gcell2.decY = edgeId;
+            }
+        }
+    });
+    nonViaEdges = numHoriz + numVert;
+
+    // vias, one column per task; via capacity is not considered
+    parallelFor(sizeX, threads, [&](std::size_t col, unsigned) {
+        const CoordType x = static_cast<CoordType>(col);
+        for (CoordType y = 0; y < sizeY; ++y) {
+            const IdType edgeId = nonViaEdges + x * sizeY + y;
+            GCell &gcell1 = gcellArr3D[0][y][x], &gcell2 = gcellArr3D[1][y][x];
+            makeEdge(edgeId, gcell1, gcell2, VIA, 255U);
+            gcell1.incZ = edgeId;
+            gcell2.decZ = edgeId;
+        }
+    });
+
+    // every wire edge costs at least edgeBase under either cost function
+    unitBound.assign(std::vector<CostType>(gcellArrSzX - 1, edgeBase), std::vector<CostType>(gcellArrSzY - 1, edgeBase));
+    dlmBound = unitBound;
+
+    if (params.routeCache) { routeCache.resize(gcellArrSzX, gcellArrSzY); }
+    if (params.longNetSpan > 0) { longNetThreads = resolveThreads(params.threads); }
+    searchDeadline = params.deadline > 0.;
+}
+
+//@brief: build the prefix sums of the per-column and per-row edge cost bounds
+void PathLowerBound::assign(const std::vector<CostType> &colCost, const std::vector<CostType> &rowCost)
+{
+    // accumulate in double so that differences of the prefixes stay below the true sums
+    auto prefix = [](const std::vector<CostType> &cost, std::vector<CostType> &sums) {
+        sums.resize(cost.size() + 1);
+        double sum = 0.;
+        sums[0] = 0.f;
+        for (std::size_t i = 0; i < cost.size(); ++i) {
+            sum += static_cast<double>(cost[i]);
+            sums[i + 1] = static_cast<CostType>(sum);
+        }
+    };
+    std::vector<CostType> colPrefix, rowPrefix;
+    prefix(colCost, colPrefix);
+    prefix(rowCost, rowPrefix);
+
+    // searches repeat exactly while the heuristic is unchanged, see RouteCache
+    if (colPrefix != colPrefix_ || rowPrefix != rowPrefix_) {
+        colPrefix_.swap(colPrefix);
+        rowPrefix_.swap(rowPrefix);
+        ++epoch_;
     }
+}
 
-    Edge newEdge;
-    newEdge.usage = 0;
-
-    // Roughly estimate upper bound of edge vector size and allocate it
-    //  Note: all edges created this way are constructed by their default constructor
-    grEdgeArr.reserve(gcellArrSzX * gcellArrSzY * (numLayers + 1));
-
-    // add horizontal edges on the first layer
-    for (CoordType j = 0; j < gcellArrSzY; ++j) {
-        for (CoordType i = 0; i < gcellArrSzX - 1; ++i) {
-            // fill up edge data
-            IdType edgeId = static_cast<IdType>(grEdgeArr.size());
-            newEdge.gcell1 = &gcellArr3D[0][j][i];
-            newEdge.gcell2 = &gcellArr3D[0][j][i + 1];
-            newEdge.capacity = horizCaps[0];
-            newEdge.type = HORIZ;
-            newEdge.layer = 0;
-            newEdge.id = edgeId;
-            // fill up gcell data
-            newEdge.gcell1->incX = edgeId;
-            newEdge.gcell2->decX = edgeId;
-            newEdge.gcell1->setCoord(i, j, 0);
-            if (i == gcellArrSzX - 2) {// last gcell on the row
-                newEdge.gcell2->setCoord(i + 1, j, 0);
-            }
-            // save edge
-            grEdgeArr.push_back(newEdge);
+//@brief: a fixed pseudo-random 64-bit weight per edge and kind of change (splitmix64)
+static uint64_t edgeWeight(IdType edgeId, uint64_t kind)
+{
+    uint64_t z = (static_cast<uint64_t>(edgeId) << 1 | kind) + 0x9e3779b97f4a7c15ULL;
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+void RouteCache::resize(IdType sizeX, IdType sizeY)
+{
+    tilesX_ = (sizeX + tileSize - 1) / tileSize;
+    tilesY_ = (sizeY + tileSize - 1) / tileSize;
+    usageHash_.assign(static_cast<std::size_t>(tilesX_) * tilesY_, 0);
+    fullHash_.assign(usageHash_.size(), 0);
+    entries_.clear();
+}
+
+void RouteCache::touchUsage(const Edge &edge, int64_t usageDelta, int fullDelta)
+{
+    if (usageHash_.empty()) { return; }
+    const std::size_t tile = (edge.gcell1->y / tileSize) * tilesX_ + edge.gcell1->x / tileSize;
+    // adding and removing the same wire cancel out exactly
+    usageHash_[tile] += edgeWeight(edge.id, 0) * static_cast<uint64_t>(usageDelta);
+    fullHash_[tile] += edgeWeight(edge.id, 0) * static_cast<uint64_t>(static_cast<int64_t>(fullDelta));
+}
+
+void RouteCache::touchHistory(const Edge &edge)
+{
+    if (usageHash_.empty()) { return; }
+    usageHash_[(edge.gcell1->y / tileSize) * tilesX_ + edge.gcell1->x / tileSize] += edgeWeight(edge.id, 1);
+}
+
+uint64_t RouteCache::fingerprint(const Entry &entry) const
+{
+    const std::vector<uint64_t> &hashes = entry.usageFree ? fullHash_ : usageHash_;
+    uint64_t sum = 0;
+    for (IdType ty = entry.tileLo.y; ty <= entry.tileHi.y; ++ty) {
+        for (IdType tx = entry.tileLo.x; tx <= entry.tileHi.x; ++tx) {
+            // weight the tiles so that changes in different tiles cannot cancel
+            sum += hashes[ty * tilesX_ + tx] * (2 * (ty * tilesX_ + tx) + 1);
         }
     }
+    return sum;
+}
+
+const RouteCache::Entry *RouteCache::find(const Key &key, unsigned boundEpoch, CostType weight)
+{
+    const auto it = entries_.find(key);
+    if (it == entries_.end() || it->second.boundEpoch != boundEpoch || it->second.weight != weight
+        || it->second.fingerprint != fingerprint(it->second)) {
+        ++misses;
+        return NULL;
+    }
+    ++hits;
+    return &it->second;
+}
+
+void RouteCache::store(const Key &key, Entry &&entry)
+{
+    if (usageHash_.empty()) { return; }
+    entry.fingerprint = fingerprint(entry);
+    entries_[key] = std::move(entry);
+}
+
+IdType NetNameIndex::add(std::string_view name, IdType netId)
+{
+    chars_.append(name.data(), name.size());
+    begin_.push_back(chars_.size());
+    netIds_.push_back(netId);
+    hashes_.push_back(hash(name));
+    return static_cast<IdType>(netIds_.size() - 1);
+}
 
-    // add vertical edge on the second layer
-    for (CoordType i = 0; i < gcellArrSzX; ++i) {
-        for (CoordType j = 0; j < gcellArrSzY - 1; ++j) {
-            // fill up edge data
-            IdType edgeId = static_cast<IdType>(grEdgeArr.size());
-            newEdge.gcell1 = &gcellArr3D[1][j][i];
-            newEdge.gcell2 = &gcellArr3D[1][j + 1][i];
-            newEdge.capacity = vertCaps[1];
-            newEdge.type = VERT;
-            newEdge.layer = 1;
-            newEdge.id = edgeId;
-            // fill up gcell data
-            newEdge.gcell1->incY = edgeId;
-            newEdge.gcell2->decY = edgeId;
-            newEdge.gcell1->setCoord(i, j, 1);
-            if (j == gcellArrSzY - 2) {// last gcell on the column
-                newEdge.gcell2->setCoord(i, j + 1, 1);
+void NetNameIndex::build(void)
+{
+    std::size_t numSlots = 16;
+    while (numSlots < 2 * netIds_.size()) { numSlots *= 2; }
+    slots_.assign(numSlots, 0);
+    const std::size_t mask = numSlots - 1;
+    for (IdType entry = 0; entry < netIds_.size(); ++entry) {
+        for (std::size_t slot = hashes_[entry] & mask;; slot = (slot + 1) & mask) {
+            const IdType other = slots_[slot];
+            if (other == 0 || (hashes_[other - 1] == hashes_[entry] && name(other - 1) == name(entry))) {
+                slots_[slot] = entry + 1;
+                break;
             }
-            // save edge
-            grEdgeArr.push_back(newEdge);
         }
     }
+}
 
-    nonViaEdges = static_cast<IdType>(grEdgeArr.size());
-
-    // add vias
-    for (unsigned i = 0; i < gcellArrSzX; ++i) {
-        for (unsigned j = 0; j < gcellArrSzY; ++j) {
-            IdType edgeId = static_cast<IdType>(grEdgeArr.size());
-            newEdge.gcell1 = &gcellArr3D[0][j][i];
-            newEdge.gcell2 = &gcellArr3D[1][j][i];
-            newEdge.capacity = 255U;// via capacity is not considered
-            newEdge.type = VIA;
-            newEdge.id = edgeId;
-
-            newEdge.gcell1->incZ = edgeId;
-            newEdge.gcell2->decZ = edgeId;
-            grEdgeArr.push_back(newEdge);
+bool NetNameIndex::find(std::string_view key, IdType &netId) const
+{
+    if (slots_.empty()) { return false; }
+    const uint32_t h = hash(key);
+    const std::size_t mask = slots_.size() - 1;
+    for (std::size_t slot = h & mask; slots_[slot] != 0; slot = (slot + 1) & mask) {
+        const IdType entry = slots_[slot] - 1;
+        if (hashes_[entry] == h && name(entry) == key) {
+            netId = netIds_[entry];
+            return true;
         }
     }
+    return false;
+}
+
+//@brief: FNV-1a, folded to 32 bits
+uint32_t NetNameIndex::hash(std::string_view name)
+{
+    const uint64_t h = fnv1a(name.data(), name.size());
+    return static_cast<uint32_t>(h ^ (h >> 32));
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -175,6 +337,7 @@ IdType PQueue::getBestGCell(void) const
 // Remove the element at the top of the priority queue
 void PQueue::rmBestGCell(void)
 {
+    GR_PROFILE_SCOPE("PQueue::rmBestGCell");
     assert(!isEmpty());
 
     data[heap.back()].heapLoc = 0;
@@ -224,6 +387,7 @@ void PQueue::rmBestGCell(void)
 //        where totalCost = pathCost + heuristicCost
 void PQueue::setGCellCost(IdType gcellId, CostType totalCost, CostType pathCost, IdType parent)
 {
+    GR_PROFILE_SCOPE("PQueue::setGCellCost");
     // printf("New gcell added %d with cost %f\n", gcellId, pathCost);
     if (dataValid.isBitSet(gcellId)) {
         if (totalCost < data[gcellId].totalCost) {
@@ -290,6 +454,8 @@ void PQueue::clear(void)
 //        changes in edge usage and overflow
 void SimpleGR::addSegment(Net &net, Edge &edge)
 {
+    GR_PROFILE_SCOPE("addSegment");
+
     IdType netId = net.id;
     IdType edgeId = edge.id;
     const CapType curDmd = edge.type == VIA ? 0 : minWidths[edge.layer] + minSpacings[edge.layer];
@@ -302,9 +468,12 @@ void SimpleGR::addSegment(Net &net, Edge &edge)
     assert(pos3 == edge.nets.end() || *pos3 != netId);
     edge.nets.insert(pos3, netId);
 
+    const bool hadRoom = edgeHasRoom(edge);
     CapType oldOverflow = edge.usage > edge.capacity ? edge.usage - edge.capacity : 0;
     totalOverflow -= oldOverflow;
     edge.usage += curDmd;
+    routeCache.touchUsage(edge, curDmd, hadRoom && !edgeHasRoom(edge) ? 1 : 0);
+    if (hadRoom && !edgeHasRoom(edge)) { wavefront.setRoom(edge, false); }
     CapType newOverflow = edge.usage > edge.capacity ? edge.usage - edge.capacity : 0;
     totalOverflow += newOverflow;
     if (oldOverflow == 0 && newOverflow > 0) { ++overfullEdges; }
@@ -321,17 +490,26 @@ void SimpleGR::addSegment(Net &net, Edge &edge)
 //        changes in edge usage and overflow
 void SimpleGR::ripUpSegment(const IdType netId, IdType edgeId)
 {
+    GR_PROFILE_SCOPE("ripUpSegment");
+
     Edge &edge = grEdgeArr[edgeId];
     const CapType curDmd = grEdgeArr[edgeId].type == VIA ? 0 : minWidths[edge.layer] + minSpacings[edge.layer];
 
     assert(edge.usage >= curDmd);
 
+    const bool hadRoom = edgeHasRoom(edge);
     CapType oldOverflow = edge.usage > edge.capacity ? edge.usage - edge.capacity : 0;
     totalOverflow -= oldOverflow;
     edge.usage -= curDmd;
+    routeCache.touchUsage(edge, -static_cast<int64_t>(curDmd), !hadRoom && edgeHasRoom(edge) ? -1 : 0);
     CapType newOverflow = edge.usage > edge.capacity ? edge.usage - edge.capacity : 0;
     totalOverflow += newOverflow;
     if (oldOverflow > 0 && newOverflow == 0) { --overfullEdges; }
+    // the edge reopened, so its gcells are connected again without overflow
+    if (!hadRoom && edgeHasRoom(edge)) {
+        freeComponents.unite(getGCellId(*edge.gcell1), getGCellId(*edge.gcell2));
+        wavefront.setRoom(edge, true);
+    }
     if (edge.type == VIA) {
         --grNetArr[netId].numVias;
         --totalVias;
@@ -356,7 +534,27 @@ void SimpleGRParams::usage(const char *exename)
     cout << "  -o <filename>         Save routes in <filename>" << endl;
     cout << "  -maxRipIter <uint>    Maximum rip-up and re-route iterations" << endl;
     cout << "  -timeOut <double>     Rip-up and re-route timeout (seconds)" << endl;
+    cout << "  -deadline <double>    Wall clock limit of the whole run (seconds), remaining nets" << endl;
+    cout << "                        get pattern routes once it passes" << endl;
+    cout << "  -checkpoint <file>    Save the routing state to <file> after RRR iterations" << endl;
+    cout << "  -checkpointEvery <n>  RRR iterations between checkpoints (default 1)" << endl;
+    cout << "  -resume <file>        Continue from a checkpoint instead of initial routing" << endl;
+    cout << "  -warmStart <file>     Keep the routes of a prior solution where they still fit" << endl;
+    cout << "  -congestionMap <base> Write congestion maps to <base>.<phase>.* after each phase" << endl;
+    cout << "  -mapFormat <fmt>      Congestion map format: xpm, ppm or png (default)" << endl;
+    cout << "  -mapDownsample <uint> One congestion map pixel per <uint> x <uint> gcells" << endl;
+    cout << "  -congestionMovie      Also write a congestion map after every RRR iteration" << endl;
     cout << "  -maxGreedyIter <uint> Maximum greedy iterations" << endl;
+    cout << "  -weight <double>      Weighted A* heuristic inflation (>= 1, default 1)" << endl;
+    cout << "  -tightenWeight        Halve the excess weight every RRR iteration, exact greedy" << endl;
+    cout << "  -shareSource <double> Route nets sharing a pin gcell from one shortest-path tree," << endl;
+    cout << "                        keeping tree routes whose cost grew by at most this fraction" << endl;
+    cout << "  -routeCache           Reuse searches whose surroundings did not change" << endl;
+    cout << "  -threads <uint>       Search threads for greedy improvement and long nets (0: all cores)" << endl;
+    cout << "  -longNetSpan <uint>   Search nets spanning at least this many gcells on all threads" << endl;
+    cout << "  -telemetry <filename> Log per-search metrics as CSV to <filename>" << endl;
+    cout << "  -report <filename>    Write a JSON run report to <filename>" << endl;
+    cout << "  -quiet                Suppress progress reports" << endl;
     cout << "  -h, -help             Show this page" << endl;
     cout << "Must provide option marked by *" << endl;
     cout << endl;
@@ -367,11 +565,30 @@ void SimpleGRParams::setDefault(void)
 {
     layerAssign = true;
     verbose = false;
+    quiet = false;
     maxRipIter = 20;
     maxGreedyIter = 1;
     timeOut = 60. * 5;// 5 mins
+    deadline = 0.;
+    checkpointFile = "";
+    checkpointEvery = 1;
+    resumeFile = "";
+    warmStartFile = "";
+    congestionMapFile = "";
+    mapFormat = CongestionMap::PNG;
+    mapDownsample = 1;
+    congestionMovie = false;
+    weight = 1.;
+    tightenWeight = false;
+    shareSource = false;
+    staleness = 0.;
+    routeCache = false;
+    threads = 1;
+    longNetSpan = 0;
     outputFile = "";
     inputFile = "";
+    telemetryFile = "";
+    reportFile = "";
 }
 
 void SimpleGRParams::print(void) const
@@ -382,77 +599,225 @@ void SimpleGRParams::print(void) const
     cout << "Design file to read:       " << inputFile << endl;
     cout << "Maximum RRR iterations:    " << maxRipIter << endl;
     cout << "Max RRR runtime:           " << timeOut << " seconds" << endl;
+    if (deadline > 0.) { cout << "Run deadline:              " << deadline << " seconds" << endl; }
+    if (!checkpointFile.empty()) {
+        cout << "Checkpoint file:           '" << checkpointFile << "' every " << checkpointEvery
+             << " RRR iteration(s)" << endl;
+    }
+    if (!resumeFile.empty()) { cout << "Resume from checkpoint:    '" << resumeFile << "'" << endl; }
+    if (!warmStartFile.empty()) { cout << "Warm start from solution:  '" << warmStartFile << "'" << endl; }
+    if (!congestionMapFile.empty()) {
+        cout << "Congestion maps:           '" << congestionMapFile << ".*" << CongestionMap::extension(mapFormat)
+             << "'" << (congestionMovie ? " with a frame per RRR iteration" : "") << endl;
+    }
     cout << "Maximum greedy iterations: " << maxGreedyIter << endl;
+    if (weight > 1.) {
+        cout << "Weighted A* inflation:     " << weight << (tightenWeight ? " (tightened per phase)" : "") << endl;
+    }
+    if (shareSource) { cout << "Shared source trees:       staleness " << staleness << endl; }
+    if (routeCache) { cout << "Route memoization:         on" << endl; }
+    if (threads != 1) { cout << "Search threads:            " << resolveThreads(threads) << endl; }
+    if (longNetSpan > 0) { cout << "Parallel long net search:  span " << longNetSpan << " gcells" << endl; }
     if (!outputFile.empty()) {
         cout << "Save solution to file:     '" << outputFile << "'" << endl;
     } else {
         cout << "Warning: output unspecified (-o). No solution file will be generated." << endl;
     }
+    if (!telemetryFile.empty()) { cout << "Search telemetry log:      '" << telemetryFile << "'" << endl; }
+    if (!reportFile.empty()) { cout << "JSON run report:           '" << reportFile << "'" << endl; }
     cout << endl;
 }
 
 //@brief: a simple implementation of command line parameters
 SimpleGRParams::SimpleGRParams(int argc, char **argv)
+{
+    if (!parse(argc, argv)) { usage(argv[0]); }
+}
+
+//@brief: set the parameters from command line options, the defaults for those not
+//        given. False, after printing what is wrong, for options that are not valid
+//        or a request for help.
+bool SimpleGRParams::parse(int argc, char **argv)
 {
     using namespace std;
 
     setDefault();
 
-    if (argc < 2) { usage(argv[0]); }
+    if (argc < 2) { return false; }
 
     for (int i = 1; i < argc; ++i) {
         if (argv[i] == string("-h") || argv[i] == string("-help")) {
-            usage(argv[0]);
+            return false;
         } else if (argv[i] == string("-o")) {
             if (i + 1 < argc) {
                 outputFile = argv[++i];
             } else {
                 cout << "option -o requires an argument" << endl;
-                usage(argv[0]);
+                return false;
             }
         } else if (argv[i] == string("-f")) {
             if (i + 1 < argc) {
                 inputFile = argv[++i];
             } else {
                 cout << "option -f requires an argument" << endl;
-                usage(argv[0]);
+                return false;
             }
         } else if (argv[i] == string("-maxRipIter")) {
             if (i + 1 < argc) {
                 maxRipIter = static_cast<unsigned>(atoi(argv[++i]));
             } else {
                 cout << "option -maxRipIter requires an argument" << endl;
-                usage(argv[0]);
+                return false;
             }
         } else if (argv[i] == string("-maxGreedyIter")) {
             if (i + 1 < argc) {
                 maxGreedyIter = static_cast<unsigned>(atoi(argv[++i]));
             } else {
                 cout << "option -maxGreedyIter requires an argument" << endl;
-                usage(argv[0]);
+                return false;
+            }
+        } else if (argv[i] == string("-telemetry")) {
+            if (i + 1 < argc) {
+                telemetryFile = argv[++i];
+            } else {
+                cout << "option -telemetry requires an argument" << endl;
+                return false;
+            }
+        } else if (argv[i] == string("-report")) {
+            if (i + 1 < argc) {
+                reportFile = argv[++i];
+            } else {
+                cout << "option -report requires an argument" << endl;
+                return false;
+            }
+        } else if (argv[i] == string("-quiet")) {
+            quiet = true;
+        } else if (argv[i] == string("-weight")) {
+            if (i + 1 < argc) {
+                weight = atof(argv[++i]);
+                if (weight < 1.) {
+                    cout << "option -weight must be at least 1" << endl;
+                    return false;
+                }
+            } else {
+                cout << "option -weight requires an argument" << endl;
+                return false;
+            }
+        } else if (argv[i] == string("-tightenWeight")) {
+            tightenWeight = true;
+        } else if (argv[i] == string("-shareSource")) {
+            if (i + 1 < argc) {
+                shareSource = true;
+                staleness = max(0., atof(argv[++i]));
+            } else {
+                cout << "option -shareSource requires an argument" << endl;
+                return false;
+            }
+        } else if (argv[i] == string("-threads")) {
+            if (i + 1 < argc) {
+                threads = static_cast<unsigned>(atoi(argv[++i]));
+            } else {
+                cout << "option -threads requires an argument" << endl;
+                return false;
             }
+        } else if (argv[i] == string("-longNetSpan")) {
+            if (i + 1 < argc) {
+                longNetSpan = static_cast<unsigned>(atoi(argv[++i]));
+            } else {
+                cout << "option -longNetSpan requires an argument" << endl;
+                return false;
+            }
+        } else if (argv[i] == string("-routeCache")) {
+            routeCache = true;
+        } else if (argv[i] == string("-deadline")) {
+            if (i + 1 < argc) {
+                deadline = max(0., atof(argv[++i]));
+            } else {
+                cout << "option -deadline requires an argument" << endl;
+                return false;
+            }
+        } else if (argv[i] == string("-checkpoint")) {
+            if (i + 1 < argc) {
+                checkpointFile = argv[++i];
+            } else {
+                cout << "option -checkpoint requires an argument" << endl;
+                return false;
+            }
+        } else if (argv[i] == string("-checkpointEvery")) {
+            if (i + 1 < argc) {
+                checkpointEvery = max(1U, static_cast<unsigned>(atoi(argv[++i])));
+            } else {
+                cout << "option -checkpointEvery requires an argument" << endl;
+                return false;
+            }
+        } else if (argv[i] == string("-resume")) {
+            if (i + 1 < argc) {
+                resumeFile = argv[++i];
+            } else {
+                cout << "option -resume requires an argument" << endl;
+                return false;
+            }
+        } else if (argv[i] == string("-warmStart")) {
+            if (i + 1 < argc) {
+                warmStartFile = argv[++i];
+            } else {
+                cout << "option -warmStart requires an argument" << endl;
+                return false;
+            }
+        } else if (argv[i] == string("-congestionMap")) {
+            if (i + 1 < argc) {
+                congestionMapFile = argv[++i];
+            } else {
+                cout << "option -congestionMap requires an argument" << endl;
+                return false;
+            }
+        } else if (argv[i] == string("-mapFormat")) {
+            if (i + 1 >= argc || !CongestionMap::parseFormat(argv[++i], mapFormat)) {
+                cout << "option -mapFormat requires one of xpm, ppm or png" << endl;
+                return false;
+            }
+        } else if (argv[i] == string("-mapDownsample")) {
+            if (i + 1 < argc) {
+                mapDownsample = max(1U, static_cast<unsigned>(atoi(argv[++i])));
+            } else {
+                cout << "option -mapDownsample requires an argument" << endl;
+                return false;
+            }
+        } else if (argv[i] == string("-congestionMovie")) {
+            congestionMovie = true;
         } else if (argv[i] == string("-timeOut")) {
             if (i + 1 < argc) {
                 timeOut = atof(argv[++i]);
             } else {
                 cout << "option -timeOut requires an argument" << endl;
-                usage(argv[0]);
+                return false;
             }
         } else {
             cout << "unknown commandline option" << endl;
-            usage(argv[0]);
+            return false;
         }
     }
 
     if (inputFile.empty()) {
         cout << "Must provide '-f' option" << endl;
-        usage(argv[0]);
+        return false;
     }
+    if (!resumeFile.empty() && !warmStartFile.empty()) {
+        cout << "options -resume and -warmStart cannot be combined" << endl;
+        return false;
+    }
+    if (congestionMovie && congestionMapFile.empty()) {
+        cout << "option -congestionMovie requires -congestionMap" << endl;
+        return false;
+    }
+    return true;
 }
 
 //@brief: a simple implementation to report progress of routing
 void SimpleProgRpt::update(unsigned i)
 {
+    if (quiet) { return; }
+
     int percent = static_cast<int>(i) * 100 / static_cast<int>(size);
     while (percent > checkpoint[j]) {
         j += 1;
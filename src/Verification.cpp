@@ -0,0 +1,267 @@
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Profiler.h"
+#include "SimpleGR.h"
+
+namespace {
+
+// how a net of the solution, or a GR net missing from it, fails the check
+enum NetStatus : uint8_t { NetOk, NetUnknown, NetDuplicate, NetBadSegment, NetDisconnected, NetMissing };
+const char *const statusNames[] = { "ok", "unknown", "duplicate", "bad_segment", "disconnected", "missing" };
+
+// a net as read from the solution, its edges being edges[begin, end) of its chunk
+class RouteRecord
+{
+  public:
+    std::string_view name;
+    IdType netId{ NULLID };
+    std::size_t begin{ 0 }, end{ 0 };
+    NetStatus status{ NetOk };
+    LenType wirelength{ 0 }, vias{ 0 };
+    LenType overflowEdges{ 0 };
+    uint64_t overflow{ 0 };
+};
+
+// a run of whole nets of the solution, parsed and checked by one thread at a time
+class SolutionChunk
+{
+  public:
+    std::string_view text;
+    std::vector<RouteRecord> routes;
+    std::vector<IdType> edges;
+};
+
+// offset of the first net starting at or after `pos`: just past a line starting with
+// the "!" that ends a net
+std::size_t netBoundary(std::string_view text, std::size_t pos)
+{
+    if (pos == 0) { return 0; }
+    const std::size_t bang = text.find("\n!", pos - 1);
+    if (bang == std::string_view::npos) { return text.size(); }
+    const std::size_t eol = text.find('\n', bang + 2);
+    return eol == std::string_view::npos ? text.size() : eol + 1;
+}
+
+}// namespace
+
+//@brief: check a solution file against the design loaded with parseInputMapper, without
+//        changing the grid. The file is mapped into memory and cut into chunks of whole
+//        nets that are parsed and checked in parallel: every segment must be a straight
+//        run of existing edges, every route must connect its pins, and every GR net must
+//        be routed exactly once. Edge usage is summed with atomics, then the overflow of
+//        every net's edges is reported. Returns 0 for a legal solution without overflow,
+//        1 for a legal one with overflow and 2 for an illegal one.
+int SimpleGR::verifySolution(const char *filename, const std::string &netReport)
+{
+    using namespace std;
+
+    GR_PROFILE_PHASE("verifySolution");
+
+    MappedFile file;
+    if (!file.open(filename)) {
+        cout << "Could not open `" << filename << "' for reading" << endl;
+        return 2;
+    }
+    cout << "Verifying `" << filename << "' ..." << endl;
+    const string_view text = file.text();
+    const unsigned threads = resolveThreads(params.threads);
+
+    // many more chunks than threads, so that uneven chunks balance out
+    const size_t numChunks = max<size_t>(1, min<size_t>(text.size() / (1 << 16), 64 * static_cast<size_t>(threads)));
+    vector<SolutionChunk> chunks(numChunks);
+    {
+        size_t begin = 0;
+        for (size_t k = 0; k < numChunks; ++k) {
+            const size_t end = k + 1 == numChunks ? text.size() : max(begin, netBoundary(text, text.size() / numChunks * (k + 1)));
+            chunks[k].text = text.substr(begin, end - begin);
+            begin = end;
+        }
+    }
+
+    // parse: the edges of every segment, in design coordinates with layers from 1
+    parallelFor(numChunks, threads, [&](size_t k, unsigned) {
+        SolutionChunk &chunk = chunks[k];
+        TextScanner in(chunk.text), segment;
+        // a malformed segment fails its net, the line after it is read as usual
+        segment.setFatal(false);
+        for (string_view name = in.word(); in.good(); name = in.word()) {
+            RouteRecord route;
+            route.name = name;
+            route.begin = chunk.edges.size();
+            if (!netNames.find(name, route.netId)) { route.status = NetUnknown; }
+            in.skipLine();
+
+            while (in.peek() == '(') {
+                double from[3] = { 0., 0., 0. }, to[3] = { 0., 0., 0. };
+                char c[9] = {};
+                segment.reset(in.line());
+                segment >> c[0] >> from[0] >> c[1] >> from[1] >> c[2] >> from[2] >> c[3] >> c[4] >> c[5] >> to[0]
+                    >> c[6] >> to[1] >> c[7] >> to[2] >> c[8];
+                const bool wellFormed = segment.good() && string_view(c, 9) == "(,,)-(,,)";
+                if (!wellFormed || !segmentEdges(from, to, chunk.edges)) { route.status = NetBadSegment; }
+            }
+            // the trailing !
+            if (in.peek() == '!') {
+                in.skipLine();
+            } else {
+                route.status = NetBadSegment;
+            }
+            route.end = chunk.edges.size();
+            chunk.routes.push_back(route);
+        }
+    });
+
+    // a GR net routed twice keeps its first route
+    vector<uint8_t> seen(grNetArr.size(), 0);
+    for (SolutionChunk &chunk : chunks) {
+        for (RouteRecord &route : chunk.routes) {
+            if (route.status == NetUnknown || route.netId == NULLID) { continue; }
+            if (seen[route.netId]) {
+                route.status = NetDuplicate;
+            } else {
+                seen[route.netId] = 1;
+            }
+        }
+    }
+
+    // connectivity, length and usage of every route
+    vector<atomic<uint32_t>> usage(grEdgeArr.size());
+    parallelFor(numChunks, threads, [&](size_t k, unsigned) {
+        SolutionChunk &chunk = chunks[k];
+        RouteScratch scratch;
+        vector<IdType> edges;
+        for (RouteRecord &route : chunk.routes) {
+            if (route.status == NetUnknown || route.status == NetDuplicate) { continue; }
+            edges.assign(chunk.edges.begin() + static_cast<ptrdiff_t>(route.begin),
+                chunk.edges.begin() + static_cast<ptrdiff_t>(route.end));
+            sort(edges.begin(), edges.end());
+            edges.erase(unique(edges.begin(), edges.end()), edges.end());
+            copy(edges.begin(), edges.end(), chunk.edges.begin() + static_cast<ptrdiff_t>(route.begin));
+            route.end = route.begin + edges.size();
+
+            for (const IdType e : edges) {
+                const Edge &edge = grEdgeArr[e];
+                if (edge.type == VIA) {
+                    ++route.vias;
+                } else {
+                    ++route.wirelength;
+                    usage[e].fetch_add(minWidths[edge.layer] + minSpacings[edge.layer], memory_order_relaxed);
+                }
+            }
+            if (route.status == NetOk && route.netId != NULLID
+                && !routeConnects(grNetArr[route.netId], edges, false, scratch)) {
+                route.status = NetDisconnected;
+            }
+        }
+    });
+
+    // overflow of the wire edges
+    vector<uint32_t> overflow(nonViaEdges, 0);
+    vector<uint64_t> workerOverflow(threads, 0);
+    vector<IdType> workerOverfull(threads, 0);
+    vector<uint32_t> workerMax(threads, 0);
+    const size_t edgeBlock = 1 << 16;
+    parallelFor((nonViaEdges + edgeBlock - 1) / edgeBlock, threads, [&](size_t block, unsigned worker) {
+        const size_t last = min<size_t>(nonViaEdges, (block + 1) * edgeBlock);
+        for (size_t e = block * edgeBlock; e < last; ++e) {
+            const uint32_t used = usage[e].load(memory_order_relaxed);
+            if (used <= grEdgeArr[e].capacity) { continue; }
+            overflow[e] = used - grEdgeArr[e].capacity;
+            workerOverflow[worker] += overflow[e];
+            ++workerOverfull[worker];
+            workerMax[worker] = max(workerMax[worker], overflow[e]);
+        }
+    });
+    uint64_t totalOver = 0;
+    IdType overfull = 0;
+    uint32_t maxOver = 0;
+    for (unsigned w = 0; w < threads; ++w) {
+        totalOver += workerOverflow[w];
+        overfull += workerOverfull[w];
+        maxOver = max(maxOver, workerMax[w]);
+    }
+
+    // overflow along every route
+    parallelFor(numChunks, threads, [&](size_t k, unsigned) {
+        SolutionChunk &chunk = chunks[k];
+        for (RouteRecord &route : chunk.routes) {
+            for (size_t i = route.begin; i < route.end; ++i) {
+                const IdType e = chunk.edges[i];
+                if (e < nonViaEdges && overflow[e] > 0) {
+                    ++route.overflowEdges;
+                    route.overflow += overflow[e];
+                }
+            }
+        }
+    });
+
+    // totals
+    size_t counts[NetMissing + 1] = {};
+    uint64_t wirelength = 0, vias = 0;
+    size_t overflowNets = 0;
+    vector<const RouteRecord *> worst;
+    for (const SolutionChunk &chunk : chunks) {
+        for (const RouteRecord &route : chunk.routes) {
+            ++counts[route.status];
+            if (route.status == NetUnknown || route.status == NetDuplicate) { continue; }
+            wirelength += route.wirelength;
+            vias += route.vias;
+            if (route.overflowEdges > 0) {
+                ++overflowNets;
+                worst.push_back(&route);
+            }
+        }
+    }
+    for (IdType i = 0; i < grNetArr.size(); ++i) { if (!seen[i]) { ++counts[NetMissing]; } }
+
+    const size_t illegal = counts[NetUnknown] + counts[NetDuplicate] + counts[NetBadSegment] + counts[NetDisconnected]
+                           + counts[NetMissing];
+    cout << "nets checked " << counts[NetOk] + counts[NetBadSegment] + counts[NetDisconnected] << " of "
+         << grNetArr.size() << " GR nets" << endl;
+    for (int status = NetUnknown; status <= NetMissing; ++status) {
+        if (counts[status] > 0) { cout << "nets " << statusNames[status] << " " << counts[status] << endl; }
+    }
+    cout << "total length for routed nets " << wirelength << endl;
+    cout << "total number of vias " << vias << endl;
+    cout << "total wire length " << static_cast<CostType>(wirelength) + viaFactor * static_cast<CostType>(vias) << endl;
+    cout << "number of overflowing edges is " << overfull << endl;
+    cout << "max overflow is " << maxOver << endl;
+    cout << "total overflow is " << totalOver << endl;
+    cout << "nets on overflowing edges " << overflowNets << endl;
+
+    const size_t shown = min<size_t>(worst.size(), 10);
+    partial_sort(worst.begin(), worst.begin() + static_cast<ptrdiff_t>(shown), worst.end(),
+        [](const RouteRecord *a, const RouteRecord *b) {
+            return a->overflow > b->overflow || (a->overflow == b->overflow && a->name < b->name);
+        });
+    for (size_t i = 0; i < shown; ++i) {
+        cout << "  " << worst[i]->name << " overflow " << worst[i]->overflow << " on " << worst[i]->overflowEdges
+             << " edge(s)" << endl;
+    }
+
+    if (!netReport.empty()) {
+        ofstream report(netReport.c_str());
+        report << "net,status,wirelength,vias,overflow_edges,overflow\n";
+        for (const SolutionChunk &chunk : chunks) {
+            for (const RouteRecord &route : chunk.routes) {
+                report << route.name << ',' << statusNames[route.status] << ',' << route.wirelength << ','
+                       << route.vias << ',' << route.overflowEdges << ',' << route.overflow << '\n';
+            }
+        }
+        for (IdType i = 0; i < grNetArr.size(); ++i) {
+            if (!seen[i]) { report << netNames.name(i) << ',' << statusNames[NetMissing] << ",0,0,0,0\n"; }
+        }
+        if (!report.good()) { cout << "Could not write `" << netReport << "'" << endl; }
+    }
+
+    const int status = illegal > 0 ? 2 : totalOver > 0 ? 1 : 0;
+    cout << (status == 2 ? "ILLEGAL" : status == 1 ? "LEGAL with overflow" : "LEGAL") << endl;
+    return status;
+}
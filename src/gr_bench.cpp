@@ -0,0 +1,432 @@
+// Microbenchmarks for the individual SimpleGR components.
+//
+// Every benchmark runs on fixed, seeded synthetic data so numbers are comparable
+// between builds. Results are printed as a JSON document (or written to -o <file>)
+// with one entry per benchmark: the best and median time per operation over all
+// repeats, plus throughput.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+#include "Generator.h"
+#include "SimpleGR.h"
+
+namespace {
+
+struct BenchResult
+{
+    std::string name;
+    std::string unit;
+    uint64_t opsPerRun;
+    unsigned repeats;
+    double bestNsPerOp;
+    double medianNsPerOp;
+    double bytesPerRun;
+};
+
+struct BenchOptions
+{
+    unsigned repeats = 5;
+    std::string filter;
+    std::string outputFile;
+};
+
+// A null stream buffer used to silence SimpleGR's progress output while benchmarking
+class NullBuffer : public std::streambuf
+{
+  protected:
+    int overflow(int c) override { return c; }
+};
+
+}// namespace
+
+//@brief: friend of SimpleGR, so the benchmarks can drive private routing internals directly
+class GRBench
+{
+  public:
+    GRBench(const BenchOptions &opts, std::ostream &log) : opts_(opts), log_(log) {}
+
+    void runAll(void);
+    void report(std::ostream &out) const;
+
+  private:
+    const BenchOptions &opts_;
+    std::ostream &log_;
+    std::vector<BenchResult> results_;
+
+    //@brief: time `fn` (which returns the number of operations it performed) over all repeats
+    void run(const std::string &name,
+        const std::string &unit,
+        const std::function<uint64_t(void)> &fn,
+        double bytesPerRun = 0.);
+
+    void benchPQueue(void);
+    void benchRouting(SimpleGR &gr);
+    void benchParse(const std::string &design);
+    void benchFindNet(SimpleGR &gr);
+    void benchWrite(SimpleGR &gr);
+
+    static std::vector<IdType> routeAll(SimpleGR &gr, bool allowOverflow);
+};
+
+void GRBench::run(const std::string &name,
+    const std::string &unit,
+    const std::function<uint64_t(void)> &fn,
+    double bytesPerRun)
+{
+    if (!opts_.filter.empty() && name.find(opts_.filter) == std::string::npos) { return; }
+
+    using clock = std::chrono::steady_clock;
+
+    fn();// warm-up run, also settles allocations
+
+    std::vector<double> samples;
+    uint64_t ops = 0;
+    for (unsigned r = 0; r < opts_.repeats; ++r) {
+        const auto start = clock::now();
+        ops = fn();
+        const auto stop = clock::now();
+        const double ns =
+            static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start).count());
+        samples.push_back(ns / static_cast<double>(std::max<uint64_t>(ops, 1)));
+    }
+    std::sort(samples.begin(), samples.end());
+
+    BenchResult res{ name, unit, ops, opts_.repeats, samples.front(), samples[samples.size() / 2], bytesPerRun };
+    log_ << name << ": " << res.bestNsPerOp << " ns/" << unit << " (median " << res.medianNsPerOp << ")" << std::endl;
+    results_.push_back(res);
+}
+
+void GRBench::benchPQueue(void)
+{
+    const unsigned size = 1U << 18;
+    const unsigned pushes = 1U << 16;
+
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<CostType> costDist(0.f, 1000.f);
+    std::uniform_int_distribution<IdType> idDist(0, size - 1);
+
+    std::vector<std::pair<IdType, CostType>> keys(pushes);
+    for (auto &k : keys) { k = std::make_pair(idDist(rng), costDist(rng)); }
+
+    PQueue pq;
+    pq.resize(size);
+
+    // fill the heap with random keys, then drain it
+    run("pqueue/push_pop_random", "op", [&]() -> uint64_t {
+        uint64_t ops = 0;
+        for (const auto &k : keys) {
+            pq.setGCellCost(k.first, k.second, k.second, NULLID);
+            ++ops;
+        }
+        while (!pq.isEmpty()) {
+            pq.rmBestGCell();
+            ++ops;
+        }
+        pq.clear();
+        return ops;
+    });
+
+    // repeated decrease-key on gcells already in the heap
+    run("pqueue/decrease_key", "op", [&]() -> uint64_t {
+        uint64_t ops = 0;
+        for (const auto &k : keys) {
+            pq.setGCellCost(k.first, k.second + 1000.f, k.second + 1000.f, NULLID);
+            ++ops;
+        }
+        for (const auto &k : keys) {
+            pq.setGCellCost(k.first, k.second, k.second, NULLID);
+            ++ops;
+        }
+        pq.clear();
+        return ops;
+    });
+
+    // A*-like pattern: pop the best gcell, push up to four successors with larger cost
+    run("pqueue/astar_pattern", "op", [&]() -> uint64_t {
+        uint64_t ops = 0;
+        IdType next = 0;
+        pq.setGCellCost(next++, 0.f, 0.f, NULLID);
+        while (!pq.isEmpty() && next + 4 < size && ops < 4 * pushes) {
+            const IdType best = pq.getBestGCell();
+            const CostType base = pq.getGCellData(best).totalCost;
+            pq.rmBestGCell();
+            ++ops;
+            for (unsigned s = 0; s < 4; ++s) {
+                const CostType c = base + keys[(next + s) % pushes].second * 0.01f;
+                pq.setGCellCost(next + s, c, c, best);
+                ++ops;
+            }
+            next += 4;
+        }
+        pq.clear();
+        return ops;
+    });
+}
+
+//@brief: route every net once with DLM cost, returns the net IDs in routing order
+std::vector<IdType> GRBench::routeAll(SimpleGR &gr, bool allowOverflow)
+{
+    std::vector<IdType> order;
+    for (IdType i = 0; i < gr.grNetArr.size(); ++i) { order.push_back(i); }
+    std::sort(order.begin(), order.end(), CompareByBox(&gr.grNetArr));
+
+    const DLMEdgeCost dlm(gr);
+    for (const IdType id : order) {
+        if (!gr.grNetArr[id].routed) { gr.routeNet(gr.grNetArr[id], allowOverflow, false, dlm); }
+    }
+    return order;
+}
+
+void GRBench::benchRouting(SimpleGR &gr)
+{
+    std::vector<Edge *> path;
+    const Point origin(0, 0, 0);
+    const Point corner(gr.gcellArrSzX, gr.gcellArrSzY, 0);
+    const std::size_t numSearches = std::min<std::size_t>(gr.grNetArr.size(), 2000);
+
+    auto searchAll = [&](auto cost, auto allowOverflow) -> uint64_t {
+        for (std::size_t i = 0; i < numSearches; ++i) {
+            NoSearchStats stats;
+            gr.routeMaze<decltype(cost), decltype(allowOverflow)::value>(
+                gr.grNetArr[i], origin, corner, cost, path, stats);
+        }
+        return numSearches;
+    };
+    auto sweepAll = [&](auto allowOverflow) -> uint64_t {
+        for (std::size_t i = 0; i < numSearches; ++i) {
+            NoSearchStats stats;
+            gr.routeWavefront<decltype(allowOverflow)::value>(gr.grNetArr[i], origin, corner, path, stats);
+        }
+        return numSearches;
+    };
+    const std::true_type allowOverflow;
+    const std::false_type noOverflow;
+    const DLMEdgeCost cost(gr);
+    gr.buildWavefront();
+
+    // searches on the empty grid
+    run("routeMaze/unit_empty", "search", [&]() { return searchAll(UnitEdgeCost(gr), allowOverflow); });
+    run("routeWavefront/unit_empty", "search", [&]() { return sweepAll(allowOverflow); });
+    run("routeMaze/dlm_empty", "search", [&]() { return searchAll(cost, allowOverflow); });
+
+    // commit a full initial solution, then search again on the congested grid
+    const std::vector<IdType> order = routeAll(gr, true);
+    run("routeMaze/dlm_congested", "search", [&]() { return searchAll(cost, allowOverflow); });
+    run("routeMaze/dlm_congested_no_overflow", "search", [&]() { return searchAll(cost, noOverflow); });
+    run("routeMaze/unit_congested_no_overflow", "search", [&]() { return searchAll(UnitEdgeCost(gr), noOverflow); });
+    run("routeWavefront/unit_congested_no_overflow", "search", [&]() { return sweepAll(noOverflow); });
+
+    // the longest nets, searched alone and by delta-stepping on every hardware thread
+    std::vector<IdType> longNets(gr.grNetArr.size());
+    for (IdType i = 0; i < longNets.size(); ++i) { longNets[i] = i; }
+    auto span = [&gr](IdType id) {
+        const Net &net = gr.grNetArr[id];
+        return std::max(net.gCellOne.x, net.gCellTwo.x) - std::min(net.gCellOne.x, net.gCellTwo.x)
+               + std::max(net.gCellOne.y, net.gCellTwo.y) - std::min(net.gCellOne.y, net.gCellTwo.y);
+    };
+    std::stable_sort(longNets.begin(), longNets.end(), [&](IdType a, IdType b) { return span(a) > span(b); });
+    longNets.resize(std::min<std::size_t>(longNets.size(), 64));
+    run("routeMaze/dlm_long", "search", [&]() -> uint64_t {
+        for (const IdType id : longNets) {
+            NoSearchStats stats;
+            gr.routeMaze<DLMEdgeCost, true>(gr.grNetArr[id], origin, corner, cost, path, stats);
+        }
+        return longNets.size();
+    });
+    gr.longNetThreads = resolveThreads(0);
+    run("routeDelta/dlm_long", "search", [&]() -> uint64_t {
+        for (const IdType id : longNets) {
+            NoSearchStats stats;
+            gr.routeDelta<DLMEdgeCost, true>(gr.grNetArr[id], origin, corner, cost, path, stats);
+        }
+        return longNets.size();
+    });
+    gr.longNetThreads = 1;
+
+    run("edgecost/dlm", "edge", [&]() -> uint64_t {
+        CostType sum = 0.f;
+        for (IdType e = 0; e < gr.nonViaEdges; ++e) { sum += cost(e); }
+        volatile CostType sink = sum;
+        static_cast<void>(sink);
+        return gr.nonViaEdges;
+    });
+
+    // rip up every net and commit the same segments again
+    run("segments/ripup_add", "segment", [&]() -> uint64_t {
+        uint64_t ops = 0;
+        std::vector<IdType> segs;
+        for (const IdType id : order) {
+            Net &net = gr.grNetArr[id];
+            segs = net.segments;
+            gr.ripUpNet(id);
+            for (const IdType e : segs) { gr.addSegment(net, gr.grEdgeArr[e]); }
+            net.routed = !segs.empty();
+            ops += 2 * segs.size();
+        }
+        return ops;
+    });
+}
+
+static double fileSize(const std::string &filename)
+{
+    std::ifstream probe(filename.c_str(), std::ios::binary | std::ios::ate);
+    return probe.good() ? static_cast<double>(probe.tellg()) : 0.;
+}
+
+void GRBench::benchParse(const std::string &design)
+{
+    SimpleGRParams params;
+    params.inputFile = design;
+
+    run(
+        "io/parseInput",
+        "design",
+        [&]() -> uint64_t {
+            SimpleGR gr(params);
+            gr.parseInput();
+            return 1;
+        },
+        fileSize(design));
+}
+
+//@brief: name lookups of every net of a parsed design, in shuffled order
+void GRBench::benchFindNet(SimpleGR &gr)
+{
+    std::vector<std::string> names;
+    for (IdType i = 0; i < gr.netNames.size(); ++i) { names.emplace_back(gr.netNames.name(i)); }
+    std::shuffle(names.begin(), names.end(), std::mt19937(1));
+
+    run("io/findNet", "lookup", [&]() -> uint64_t {
+        uint64_t found = 0;
+        for (const auto &name : names) {
+            IdType netId;
+            if (gr.netNames.find(name, netId)) { ++found; }
+        }
+        return found;
+    });
+}
+
+//@brief: expects a routed design with params.outputFile set
+void GRBench::benchWrite(SimpleGR &gr)
+{
+    run("io/writeRoutes", "design", [&]() -> uint64_t {
+        gr.writeRoutes();
+        return 1;
+    });
+    if (!results_.empty() && results_.back().name == "io/writeRoutes") {
+        results_.back().bytesPerRun = fileSize(gr.params.outputFile);
+    }
+}
+
+void GRBench::runAll(void)
+{
+    const std::string base = "/tmp/gr_bench_" + std::to_string(getpid());
+    const std::string design = base + ".gr";
+    const std::string routes = base + ".routes";
+
+    {
+        DesignSpec spec;
+        spec.sizeX = spec.sizeY = 256;
+        spec.numNets = 30000;
+        spec.seed = 1;
+        std::ofstream out(design.c_str());
+        writeDesign(out, spec);
+    }
+
+    // silence SimpleGR's console output while it's being benchmarked
+    NullBuffer nullBuffer;
+    std::streambuf *coutBuffer = std::cout.rdbuf(&nullBuffer);
+
+    benchPQueue();
+    benchParse(design);
+    {
+        // the write benchmark reuses the solution left behind by the routing benchmarks
+        SimpleGRParams params;
+        params.inputFile = design;
+        params.outputFile = routes;
+        SimpleGR gr(params);
+        gr.parseInput();
+        benchFindNet(gr);
+        benchRouting(gr);
+        benchWrite(gr);
+    }
+
+    std::cout.rdbuf(coutBuffer);
+
+    std::remove(design.c_str());
+    std::remove(routes.c_str());
+}
+
+void GRBench::report(std::ostream &out) const
+{
+    out << "{\n  \"version\": \"" << SimpleGRversion << "\",\n  \"repeats\": " << opts_.repeats
+        << ",\n  \"benchmarks\": [\n";
+    for (std::size_t i = 0; i < results_.size(); ++i) {
+        const BenchResult &r = results_[i];
+        out << "    {\"name\": \"" << r.name << "\", \"unit\": \"" << r.unit << "\", \"ops_per_run\": " << r.opsPerRun
+            << ", \"best_ns_per_op\": " << r.bestNsPerOp << ", \"median_ns_per_op\": " << r.medianNsPerOp
+            << ", \"ops_per_sec\": " << 1.e9 / r.bestNsPerOp;
+        if (r.bytesPerRun > 0.) { out << ", \"mb_per_sec\": " << r.bytesPerRun / r.bestNsPerOp * 1.e3; }
+        out << "}" << (i + 1 < results_.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n}\n";
+}
+
+void usage(const char *exename)
+{
+    std::cout << "Usage: " << exename << " [options]\n";
+    std::cout << "Available options:\n";
+    std::cout << "  -o <filename>         Write JSON results to <filename> instead of stdout\n";
+    std::cout << "  -repeat <uint>        Timed repeats per benchmark (default 5)\n";
+    std::cout << "  -filter <substring>   Only run benchmarks whose name contains <substring>\n" << std::endl;
+}
+
+int main(int argc, char **argv)
+{
+    BenchOptions opts;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "-h" || arg == "-help") {
+            usage(argv[0]);
+            return 0;
+        } else if ((arg == "-o" || arg == "-repeat" || arg == "-filter") && i + 1 >= argc) {
+            std::cout << "option " << arg << " requires an argument" << std::endl;
+            usage(argv[0]);
+            return 1;
+        } else if (arg == "-o") {
+            opts.outputFile = argv[++i];
+        } else if (arg == "-repeat") {
+            opts.repeats = static_cast<unsigned>(std::max(1, atoi(argv[++i])));
+        } else if (arg == "-filter") {
+            opts.filter = argv[++i];
+        } else {
+            std::cout << "unknown commandline option" << std::endl;
+            usage(argv[0]);
+            return 1;
+        }
+    }
+
+    // progress goes to stderr so stdout stays machine-readable
+    GRBench bench(opts, std::cerr);
+    bench.runAll();
+
+    if (opts.outputFile.empty()) {
+        bench.report(std::cout);
+    } else {
+        std::ofstream out(opts.outputFile.c_str());
+        bench.report(out);
+    }
+
+    return 0;
+}
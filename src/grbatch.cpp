@@ -0,0 +1,177 @@
+#include <atomic>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "SimpleGR.h"
+
+//@brief: a line of the manifest, a design and the router options for it
+class BatchJob
+{
+  public:
+    std::string design;
+    std::vector<std::string> options;
+    SimpleGRParams params;
+    RouteStatistics stats;
+    double seconds{ 0. };
+    std::string error;// why the design could not be read, empty if it was routed
+};
+
+void usage(const char *exename)
+{
+    std::cout << "Usage: " << exename << " <manifest> [options]\n";
+    std::cout << "Each line of the manifest is a design file followed by SimpleGR options for it;\n";
+    std::cout << "empty lines and lines starting with # are skipped.\n";
+    std::cout << "Available options:\n";
+    std::cout << "  -jobs <uint>          Designs routed at a time (default 0: one per core)\n";
+    std::cout << "  Any other option is a SimpleGR option for every design, before those of its line.\n";
+    std::cout << "  Without -o a design writes its solution next to it, as <design>.out; its log\n";
+    std::cout << "  goes to <solution>.log.\n" << std::endl;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 2) {
+        usage(argv[0]);
+        return 0;
+    }
+
+    unsigned jobsAtOnce = 0;
+    std::vector<std::string> common;
+    for (int i = 2; i < argc; ++i) {
+        if (argv[i] == std::string("-h") || argv[i] == std::string("-help")) {
+            usage(argv[0]);
+            return 0;
+        }
+        if (argv[i] == std::string("-jobs")) {
+            if (i + 1 < argc) {
+                jobsAtOnce = static_cast<unsigned>(atoi(argv[++i]));
+            } else {
+                std::cout << "option -jobs requires an argument" << std::endl;
+                usage(argv[0]);
+                return 0;
+            }
+        } else {
+            common.push_back(argv[i]);
+        }
+    }
+
+    std::ifstream manifest(argv[1]);
+    if (!manifest.good()) {
+        std::cout << "Could not open `" << argv[1] << "' for reading" << std::endl;
+        return 1;
+    }
+
+    // parse the options of every design up front, so that a bad line stops the batch
+    // before anything is routed
+    std::vector<BatchJob> jobs;
+    std::string line;
+    while (std::getline(manifest, line)) {
+        std::istringstream words(line);
+        BatchJob job;
+        if (!(words >> job.design) || job.design[0] == '#') { continue; }
+        for (std::string word; words >> word;) { job.options.push_back(word); }
+
+        if (!std::ifstream(job.design).good()) {
+            std::cout << "Could not open `" << job.design << "' for reading" << std::endl;
+            return 1;
+        }
+        std::vector<std::string> args{ argv[0] };
+        args.insert(args.end(), common.begin(), common.end());
+        args.push_back("-f");
+        args.push_back(job.design);
+        args.insert(args.end(), job.options.begin(), job.options.end());
+        std::vector<char *> argPtrs;
+        for (std::string &arg : args) { argPtrs.push_back(&arg[0]); }
+        if (!job.params.parse(static_cast<int>(argPtrs.size()), argPtrs.data())) {
+            std::cout << "Invalid SimpleGR options for `" << job.design << "'" << std::endl;
+            return 1;
+        }
+        // the files a job starts from are checked with the design
+        for (const std::string &file : { job.params.resumeFile, job.params.warmStartFile }) {
+            if (!file.empty() && !std::ifstream(file).good()) {
+                std::cout << "Could not open `" << file << "' for reading" << std::endl;
+                return 1;
+            }
+        }
+        if (job.params.outputFile.empty()) {
+            const std::size_t dot = job.design.rfind('.');
+            const bool hasExtension = dot != std::string::npos && job.design.find('/', dot) == std::string::npos;
+            job.params.outputFile = (hasExtension ? job.design.substr(0, dot) : job.design) + ".out";
+        }
+        jobs.push_back(job);
+    }
+    if (jobs.empty()) {
+        std::cout << "No designs in `" << argv[1] << "'" << std::endl;
+        return 0;
+    }
+
+    const unsigned workers = std::min<unsigned>(resolveThreads(jobsAtOnce), static_cast<unsigned>(jobs.size()));
+    std::cout << "Routing " << jobs.size() << " design(s), " << workers << " at a time" << std::endl;
+
+    ThreadLogBuf threadLog(std::cout.rdbuf());
+    std::streambuf *const console = std::cout.rdbuf(&threadLog);
+    std::mutex consoleMutex;
+    std::atomic<std::size_t> nextJob{ 0 };
+    std::size_t finished = 0;
+
+    // each worker routes designs one after the other, each in the buffers of the one before
+    runWorkers(workers, [&](unsigned) {
+        RouterBuffers buffers;
+        for (std::size_t k = nextJob++; k < jobs.size(); k = nextJob++) {
+            BatchJob &job = jobs[k];
+            const double start = wallTime();
+            std::ofstream log(job.params.outputFile + ".log");
+            if (log.is_open()) { ThreadLogBuf::target = log.rdbuf(); }
+            {
+                SimpleGR simplegr(job.params);
+                simplegr.adoptBuffers(buffers);
+                // a malformed design or checkpoint fails its job only
+                bool readable = simplegr.parseInput();
+                if (readable) {
+                    simplegr.printParams();
+                    readable = simplegr.route();
+                }
+                if (readable) {
+                    job.stats = simplegr.statistics();
+                    simplegr.printStatistics(true, true);
+                    simplegr.writeRoutes();
+                    simplegr.writeReport();
+                } else {
+                    job.error = simplegr.parseError();
+                }
+                simplegr.releaseBuffers(buffers);
+            }
+            std::cout << std::flush;
+            ThreadLogBuf::target = nullptr;
+            job.seconds = wallTime() - start;
+
+            const std::lock_guard<std::mutex> lock(consoleMutex);
+            std::cout << "[" << ++finished << "/" << jobs.size() << "] " << job.design << ": ";
+            if (!job.error.empty()) {
+                std::cout << "failed, " << job.error << std::endl;
+                continue;
+            }
+            std::cout << "routed " << job.stats.netsRouted << "/" << job.stats.routableNets << ", wire length "
+                      << job.stats.wireLength << ", total overflow " << job.stats.totalOverflow << ", "
+                      << job.seconds << " seconds" << std::endl;
+        }
+    });
+
+    std::cout.rdbuf(console);
+    unsigned overflowing = 0, failed = 0;
+    for (const BatchJob &job : jobs) {
+        overflowing += job.stats.totalOverflow > 0 ? 1 : 0;
+        if (!job.error.empty()) { ++failed; }
+    }
+    std::cout << "Routed " << jobs.size() - failed << " design(s) in " << wallTime() << " seconds, " << overflowing
+              << " with overflow";
+    if (failed > 0) { std::cout << ", " << failed << " could not be read"; }
+    std::cout << std::endl;
+
+    return failed > 0 ? 1 : 0;
+}
@@ -0,0 +1,107 @@
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include "Generator.h"
+
+void usage(const char *exename)
+{
+    std::cout << "Usage: " << exename << " -o <filename> [options]\n";
+    std::cout << "Available options:\n";
+    std::cout << "* -o <filename>              Write the design to <filename> ('-' for stdout)\n";
+    std::cout << "  -x <uint>                  Grid columns (default 256)\n";
+    std::cout << "  -y <uint>                  Grid rows (default 256)\n";
+    std::cout << "  -nets <uint>               Number of nets (default 20000)\n";
+    std::cout << "  -lenDist <name>            Net length distribution: uniform, geometric, mixed (default geometric)\n";
+    std::cout << "  -meanLen <double>          Mean net length in gcells for geometric lengths (default 8)\n";
+    std::cout << "  -maxLen <uint>             Maximum net length in gcells (default 64)\n";
+    std::cout << "  -blockage <double>         Fraction of the die covered by macros, 0..0.9 (default 0)\n";
+    std::cout << "  -hcap <uint>               Horizontal edge capacity (default 10)\n";
+    std::cout << "  -vcap <uint>               Vertical edge capacity (default 10)\n";
+    std::cout << "  -capProfile <name>         Capacity profile: uniform, center, random (default uniform)\n";
+    std::cout << "  -capDepth <double>         Capacity taken away by the profile, 0..1 (default 0.5)\n";
+    std::cout << "  -seed <uint>               Random seed (default 1)\n";
+    std::cout << "  -h, -help                  Show this page\n" << std::endl;
+}
+
+int main(int argc, char **argv)
+{
+    DesignSpec spec;
+    std::string outputFile;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "-h" || arg == "-help") {
+            usage(argv[0]);
+            return 0;
+        }
+        if (i + 1 >= argc) {
+            std::cout << "option " << arg << " requires an argument" << std::endl;
+            usage(argv[0]);
+            return 1;
+        }
+        const std::string value = argv[++i];
+        if (arg == "-o") {
+            outputFile = value;
+        } else if (arg == "-x") {
+            spec.sizeX = static_cast<uint32_t>(atoi(value.c_str()));
+        } else if (arg == "-y") {
+            spec.sizeY = static_cast<uint32_t>(atoi(value.c_str()));
+        } else if (arg == "-nets") {
+            spec.numNets = static_cast<uint32_t>(atoi(value.c_str()));
+        } else if (arg == "-lenDist") {
+            if (!DesignSpec::parseLengthDist(value, spec.lengthDist)) {
+                std::cout << "unknown length distribution `" << value << "'" << std::endl;
+                return 1;
+            }
+        } else if (arg == "-meanLen") {
+            spec.meanLength = atof(value.c_str());
+        } else if (arg == "-maxLen") {
+            spec.maxLength = static_cast<uint32_t>(atoi(value.c_str()));
+        } else if (arg == "-blockage") {
+            spec.blockageDensity = atof(value.c_str());
+        } else if (arg == "-hcap") {
+            spec.horizCap = static_cast<uint32_t>(atoi(value.c_str()));
+        } else if (arg == "-vcap") {
+            spec.vertCap = static_cast<uint32_t>(atoi(value.c_str()));
+        } else if (arg == "-capProfile") {
+            if (!DesignSpec::parseCapProfile(value, spec.capProfile)) {
+                std::cout << "unknown capacity profile `" << value << "'" << std::endl;
+                return 1;
+            }
+        } else if (arg == "-capDepth") {
+            spec.capDepth = atof(value.c_str());
+        } else if (arg == "-seed") {
+            spec.seed = static_cast<uint32_t>(atoi(value.c_str()));
+        } else {
+            std::cout << "unknown commandline option" << std::endl;
+            usage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (outputFile.empty()) {
+        std::cout << "Must provide '-o' option" << std::endl;
+        usage(argv[0]);
+        return 1;
+    }
+    if (spec.sizeX < 2 || spec.sizeY < 2 || spec.horizCap == 0 || spec.vertCap == 0 || spec.horizCap > 255
+        || spec.vertCap > 255) {
+        std::cout << "grid must be at least 2x2 and capacities within 1..255" << std::endl;
+        return 1;
+    }
+
+    if (outputFile == "-") {
+        writeDesign(std::cout, spec);
+    } else {
+        std::ofstream out(outputFile.c_str());
+        if (!out.good()) {
+            std::cout << "Could not open `" << outputFile << "' for writing." << std::endl;
+            return 1;
+        }
+        writeDesign(out, spec);
+    }
+
+    return 0;
+}
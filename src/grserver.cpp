@@ -0,0 +1,375 @@
+#include <cerrno>
+#include <condition_variable>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "SimpleGR.h"
+
+//@brief: a design kept loaded between requests, which run on it one at a time
+class Session
+{
+  public:
+    std::mutex mutex;
+    std::string design;
+    std::unique_ptr<SimpleGR> router;
+    std::ofstream log;
+};
+
+//@brief: std::cout target of the requests on designs without a log
+class NullBuf : public std::streambuf
+{
+  protected:
+    int overflow(int c) override { return traits_type::not_eof(c); }
+    std::streamsize xsputn(const char *, std::streamsize n) override { return n; }
+};
+
+//@brief: the designs loaded and the clients connected. Every client is served on its own
+//        thread, so requests on different designs run at the same time.
+class Server
+{
+  public:
+    explicit Server(const std::string &logDir) : logDir_(logDir) {}
+
+    bool listen(const std::string &path);
+    void run(void);
+
+  private:
+    std::string logDir_, path_;
+    int listenFd_{ -1 };
+    NullBuf nullBuf_;
+
+    std::mutex sessionsMutex_;
+    std::map<std::string, std::shared_ptr<Session>> sessions_;
+
+    // connected clients, shut down on a shutdown request
+    std::mutex clientsMutex_;
+    std::condition_variable clientsDone_;
+    std::set<int> clients_;
+    bool stopping_{ false };
+
+    void serve(int fd);
+    void stop(void);
+    // the reply to a request, false if it asked the server to stop
+    bool handle(const std::string &request, std::string &reply);
+    std::shared_ptr<Session> find(const std::string &name);
+    std::streambuf *logOf(Session &session)
+    {
+        return session.log.is_open() ? static_cast<std::streambuf *>(session.log.rdbuf()) : &nullBuf_;
+    }
+};
+
+// the reply to a request that changed or queried the routing
+std::string statsReply(const RouteStatistics &stats)
+{
+    std::ostringstream reply;
+    reply << "ok routed " << stats.netsRouted << "/" << stats.routableNets << " wirelength " << stats.wireLength
+          << " vias " << stats.vias << " overflow_edges " << stats.overfullEdges << " total_overflow "
+          << stats.totalOverflow << " max_overflow " << stats.maxOverflow << "\n";
+    return reply.str();
+}
+
+bool sendAll(int fd, const std::string &data)
+{
+    for (std::size_t sent = 0; sent < data.size();) {
+        const ssize_t n = send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+        if (n <= 0) { return false; }
+        sent += static_cast<std::size_t>(n);
+    }
+    return true;
+}
+
+bool Server::listen(const std::string &path)
+{
+    sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(address.sun_path)) {
+        std::cout << "Socket path `" << path << "' is too long" << std::endl;
+        return false;
+    }
+    strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+
+    // a socket left behind by a server that did not shut down is replaced
+    struct stat status;
+    if (lstat(path.c_str(), &status) == 0) {
+        if (!S_ISSOCK(status.st_mode)) {
+            std::cout << "`" << path << "' exists and is not a socket" << std::endl;
+            return false;
+        }
+        unlink(path.c_str());
+    }
+
+    listenFd_ = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listenFd_ < 0 || bind(listenFd_, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0
+        || ::listen(listenFd_, 64) != 0) {
+        std::cout << "Could not listen on `" << path << "': " << strerror(errno) << std::endl;
+        return false;
+    }
+    path_ = path;
+    std::cout << "Listening on `" << path << "'" << std::endl;
+    return true;
+}
+
+void Server::run(void)
+{
+    for (;;) {
+        const int fd = accept(listenFd_, nullptr, nullptr);
+        if (fd < 0) {
+            if (errno == EINTR) { continue; }
+            break;
+        }
+        std::lock_guard<std::mutex> lock(clientsMutex_);
+        if (stopping_) {
+            close(fd);
+            break;
+        }
+        clients_.insert(fd);
+        std::thread(&Server::serve, this, fd).detach();
+    }
+
+    // wait for the requests still running
+    std::unique_lock<std::mutex> lock(clientsMutex_);
+    clientsDone_.wait(lock, [&]() { return clients_.empty(); });
+    close(listenFd_);
+    unlink(path_.c_str());
+    std::cout << "Server stopped" << std::endl;
+}
+
+void Server::stop(void)
+{
+    std::lock_guard<std::mutex> lock(clientsMutex_);
+    stopping_ = true;
+    // wakes up accept, and the clients waiting for their next request
+    shutdown(listenFd_, SHUT_RDWR);
+    for (const int fd : clients_) { shutdown(fd, SHUT_RD); }
+}
+
+//@brief: read the requests of a client, one per line, and send back their replies
+void Server::serve(int fd)
+{
+    std::string pending;
+    char chunk[4096];
+    bool keepRunning = true;
+    for (;;) {
+        std::size_t eol = pending.find('\n');
+        while (eol == std::string::npos) {
+            const ssize_t n = recv(fd, chunk, sizeof(chunk), 0);
+            if (n <= 0) { break; }
+            pending.append(chunk, static_cast<std::size_t>(n));
+            eol = pending.find('\n');
+        }
+        if (eol == std::string::npos) { break; }
+
+        std::string request = pending.substr(0, eol);
+        pending.erase(0, eol + 1);
+        if (!request.empty() && request.back() == '\r') { request.pop_back(); }
+        if (request.find_first_not_of(" \t") == std::string::npos) { continue; }
+
+        std::string reply;
+        keepRunning = handle(request, reply);
+        if (!sendAll(fd, reply) || !keepRunning) { break; }
+    }
+    if (!keepRunning) { stop(); }
+
+    close(fd);
+    std::lock_guard<std::mutex> lock(clientsMutex_);
+    clients_.erase(fd);
+    clientsDone_.notify_all();
+}
+
+std::shared_ptr<Session> Server::find(const std::string &name)
+{
+    std::lock_guard<std::mutex> lock(sessionsMutex_);
+    const auto it = sessions_.find(name);
+    return it == sessions_.end() ? nullptr : it->second;
+}
+
+bool Server::handle(const std::string &request, std::string &reply)
+{
+    std::istringstream in(request);
+    std::vector<std::string> words;
+    for (std::string word; in >> word;) { words.push_back(word); }
+    const std::string &command = words[0];
+
+    if (command == "shutdown") {
+        reply = "ok\n";
+        return false;
+    }
+    if (command == "list") {
+        std::lock_guard<std::mutex> lock(sessionsMutex_);
+        reply = "ok";
+        for (const auto &session : sessions_) { reply += " " + session.first; }
+        reply += "\n";
+        return true;
+    }
+    if (words.size() < 2) {
+        reply = "error usage: load <name> <design> [options] | route <name> | reroute <name> <net>... | stats "
+                "<name> | dump <name> [file] | unload <name> | list | shutdown\n";
+        return true;
+    }
+    const std::string &name = words[1];
+
+    if (command == "load") {
+        if (words.size() < 3) {
+            reply = "error usage: load <name> <design> [options]\n";
+            return true;
+        }
+        if (!std::ifstream(words[2]).good()) {
+            reply = "error could not open `" + words[2] + "'\n";
+            return true;
+        }
+        std::vector<std::string> args{ "grserver", "-f", words[2] };
+        args.insert(args.end(), words.begin() + 3, words.end());
+        std::vector<char *> argPtrs;
+        for (std::string &arg : args) { argPtrs.push_back(&arg[0]); }
+
+        auto session = std::make_shared<Session>();
+        session->design = words[2];
+        if (!logDir_.empty()) { session->log.open(logDir_ + "/" + name + ".log", std::ios::app); }
+        ThreadLogBuf::target = logOf(*session);
+        SimpleGRParams params;
+        const bool valid = params.parse(static_cast<int>(argPtrs.size()), argPtrs.data());
+        // the files the routing starts from are checked with the design
+        std::string unreadable;
+        for (const std::string &file : { params.resumeFile, params.warmStartFile }) {
+            if (valid && !file.empty() && !std::ifstream(file).good()) { unreadable = file; }
+        }
+        bool parsed = false;
+        if (valid && unreadable.empty()) {
+            session->router = std::make_unique<SimpleGR>(params);
+            parsed = session->router->parseInput();
+            if (parsed) { session->router->printParams(); }
+        }
+        std::cout << std::flush;
+        ThreadLogBuf::target = nullptr;
+        if (!valid) {
+            reply = "error invalid SimpleGR options\n";
+        } else if (!unreadable.empty()) {
+            reply = "error could not open `" + unreadable + "'\n";
+        } else if (!parsed) {
+            reply = "error " + session->router->parseError() + "\n";
+        } else {
+            reply = statsReply(session->router->statistics());
+            std::lock_guard<std::mutex> lock(sessionsMutex_);
+            sessions_[name] = session;
+        }
+        return true;
+    }
+    if (command == "unload") {
+        std::lock_guard<std::mutex> lock(sessionsMutex_);
+        reply = sessions_.erase(name) > 0 ? "ok\n" : "error no design `" + name + "'\n";
+        return true;
+    }
+
+    const std::shared_ptr<Session> session = find(name);
+    if (!session) {
+        reply = "error no design `" + name + "'\n";
+        return true;
+    }
+    std::lock_guard<std::mutex> lock(session->mutex);
+    SimpleGR &router = *session->router;
+    ThreadLogBuf::target = logOf(*session);
+
+    if (command == "route") {
+        reply = router.route() ? statsReply(router.statistics()) : "error " + router.parseError() + "\n";
+    } else if (command == "reroute") {
+        std::vector<IdType> netIds;
+        for (std::size_t i = 2; i < words.size() && reply.empty(); ++i) {
+            IdType netId = NULLID;
+            if (router.findNet(words[i], netId)) {
+                netIds.push_back(netId);
+            } else {
+                reply = "error no GR net `" + words[i] + "'\n";
+            }
+        }
+        if (reply.empty()) {
+            router.rerouteNets(netIds);
+            reply = statsReply(router.statistics());
+        }
+    } else if (command == "stats") {
+        reply = statsReply(router.statistics());
+    } else if (command == "dump") {
+        std::ostringstream solution;
+        router.writeSolution(solution);
+        if (words.size() > 2) {
+            std::ofstream outfile(words[2]);
+            outfile << solution.str();
+            reply = outfile.good() ? "ok wrote `" + words[2] + "'\n" : "error could not write `" + words[2] + "'\n";
+        } else {
+            reply = "ok " + std::to_string(solution.str().size()) + "\n" + solution.str();
+        }
+    } else {
+        reply = "error unknown request `" + command + "'\n";
+    }
+
+    std::cout << std::flush;
+    ThreadLogBuf::target = nullptr;
+    return true;
+}
+
+void usage(const char *exename)
+{
+    std::cout << "Usage: " << exename << " -socket <path> [options]\n";
+    std::cout << "Available options:\n";
+    std::cout << "* -socket <path>        Unix domain socket to listen on\n";
+    std::cout << "  -logDir <dir>         Append the router log of each design to <dir>/<name>.log\n";
+    std::cout << "Requests, one per line: load <name> <design> [SimpleGR options], route <name>,\n";
+    std::cout << "reroute <name> <net>..., stats <name>, dump <name> [file], unload <name>, list,\n";
+    std::cout << "shutdown\n" << std::endl;
+}
+
+int main(int argc, char **argv)
+{
+    std::string socketPath, logDir;
+    for (int i = 1; i < argc; ++i) {
+        if (argv[i] == std::string("-h") || argv[i] == std::string("-help")) {
+            usage(argv[0]);
+            return 0;
+        }
+        if (argv[i] == std::string("-socket") || argv[i] == std::string("-logDir")) {
+            if (i + 1 < argc) {
+                (argv[i] == std::string("-socket") ? socketPath : logDir) = argv[i + 1];
+                ++i;
+            } else {
+                std::cout << "option " << argv[i] << " requires an argument" << std::endl;
+                usage(argv[0]);
+                return 0;
+            }
+        } else {
+            std::cout << "unknown commandline option" << std::endl;
+            usage(argv[0]);
+            return 0;
+        }
+    }
+    if (socketPath.empty()) {
+        std::cout << "Must provide '-socket' option" << std::endl;
+        usage(argv[0]);
+        return 0;
+    }
+
+    signal(SIGPIPE, SIG_IGN);
+    Server server(logDir);
+    if (!server.listen(socketPath)) { return 1; }
+
+    ThreadLogBuf threadLog(std::cout.rdbuf());
+    std::streambuf *const console = std::cout.rdbuf(&threadLog);
+    server.run();
+    std::cout.rdbuf(console);
+    return 0;
+}
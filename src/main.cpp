@@ -18,11 +18,11 @@ int main(int argc, char **argv)
     SimpleGR simplegr(params);
 
     // read in the nets and create the grid input file
-    simplegr.parseInput();
+    if (!simplegr.parseInput()) { return 0; }
     simplegr.printParams();
 
     // perform 3-stage global routing
-    simplegr.initialRouting();
+    if (!simplegr.initialRouting()) { return 0; }
     simplegr.printStatistics();
 
     simplegr.doRRR();
@@ -33,6 +33,7 @@ int main(int argc, char **argv)
 
     // output solution file
     simplegr.writeRoutes();
+    simplegr.writeReport();
 
     return 0;
 }
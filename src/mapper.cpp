@@ -1,3 +1,5 @@
+#include <algorithm>
+#include <cstdlib>
 #include <iostream>
 #include <string>
 
@@ -7,7 +9,10 @@ void usage(const char *exename)
 {
     std::cout << "Usage: " << exename << " <benchname> <solnname> [options]\n";
     std::cout << "Available options:\n";
-    std::cout << "  -o <filename>         Save using base <filename>\n" << std::endl;
+    std::cout << "  -o <filename>         Save using base <filename>\n";
+    std::cout << "  -format <fmt>         Image format: xpm (default), ppm or png\n";
+    std::cout << "  -downsample <uint>    One pixel per <uint> x <uint> gcells, showing the worst\n";
+    std::cout << "  -threads <uint>       Threads for the usage ratios (default 0: all cores)\n" << std::endl;
 }
 
 int main(int argc, char **argv)
@@ -18,6 +23,11 @@ int main(int argc, char **argv)
     }
 
     std::string outputName = "congestion";
+    CongestionMap::Format format = CongestionMap::XPM;
+    unsigned downsample = 1;
+
+    SimpleGRParams parms;
+    parms.threads = 0;
 
     for (int i = 3; i < argc; ++i) {
         if (argv[i] == std::string("-h") || argv[i] == std::string("-help")) {
@@ -33,19 +43,43 @@ int main(int argc, char **argv)
                 return 0;
             }
         }
+        if (argv[i] == std::string("-format")) {
+            if (i + 1 >= argc || !CongestionMap::parseFormat(argv[i + 1], format)) {
+                std::cout << "option -format requires one of xpm, ppm or png" << std::endl;
+                usage(argv[0]);
+                return 0;
+            }
+        }
+        if (argv[i] == std::string("-downsample")) {
+            if (i + 1 < argc) {
+                downsample = std::max(1U, static_cast<unsigned>(atoi(argv[i + 1])));
+            } else {
+                std::cout << "option -downsample requires an argument" << std::endl;
+                usage(argv[0]);
+                return 0;
+            }
+        }
+        if (argv[i] == std::string("-threads")) {
+            if (i + 1 < argc) {
+                parms.threads = static_cast<unsigned>(atoi(argv[i + 1]));
+            } else {
+                std::cout << "option -threads requires an argument" << std::endl;
+                usage(argv[0]);
+                return 0;
+            }
+        }
     }
 
-    SimpleGRParams parms;
     SimpleGR simplegr(parms);
 
-    simplegr.parseInputMapper(argv[1]);
+    if (!simplegr.parseInputMapper(argv[1])) { return 0; }
 
     simplegr.parseSolution(argv[2]);
 
     bool noCheckRouted = false;
     simplegr.printStatistics(noCheckRouted);
 
-    simplegr.plotXPM(outputName);
+    simplegr.plotCongestion(outputName, format, downsample);
 
     return 0;
 }
@@ -0,0 +1,60 @@
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include "SimpleGR.h"
+
+void usage(const char *exename)
+{
+    std::cout << "Usage: " << exename << " <benchname> <solnname> [options]\n";
+    std::cout << "Available options:\n";
+    std::cout << "  -o <filename>         Write the per-net report as CSV to <filename>\n";
+    std::cout << "  -threads <uint>       Threads for parsing and checking (default 0: all cores)\n";
+    std::cout << "Exit status: 0 legal, 1 legal with overflow, 2 illegal or unreadable\n" << std::endl;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 3) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    std::string netReport;
+
+    SimpleGRParams parms;
+    parms.threads = 0;
+
+    for (int i = 3; i < argc; ++i) {
+        if (argv[i] == std::string("-h") || argv[i] == std::string("-help")) {
+            usage(argv[0]);
+            return 2;
+        }
+        if (argv[i] == std::string("-o")) {
+            if (i + 1 < argc) {
+                netReport = argv[i + 1];
+            } else {
+                std::cout << "option -o requires an argument" << std::endl;
+                usage(argv[0]);
+                return 2;
+            }
+        }
+        if (argv[i] == std::string("-threads")) {
+            if (i + 1 < argc) {
+                parms.threads = static_cast<unsigned>(atoi(argv[i + 1]));
+            } else {
+                std::cout << "option -threads requires an argument" << std::endl;
+                usage(argv[0]);
+                return 2;
+            }
+        }
+    }
+
+    SimpleGR simplegr(parms);
+
+    // blocked edges stay connected, so that wires on them count as overflow
+    if (!simplegr.parseInputMapper(argv[1])) { return 2; }
+
+    return simplegr.verifySolution(argv[2], netReport);
+}